@@ -0,0 +1,191 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_ANYMETA_HPP
+#define LML_ANYMETA_HPP
+
+/*
+  anymeta.hpp
+  ===========
+  Type erasure of staticity; one non-template type carries a metavalue
+  of any staticity, for plugin and dynamic-language boundaries, where a
+  template parameter can't cross:
+
+  * anymeta<T> : a metavalue of value_type T, from any metavalue M
+                 whose value converts to T, holding
+
+    anymeta_kind::constant   a snapshot of metaconst M's value
+    anymeta_kind::indirect   a pointer to the static of metastatic M,
+                             e.g. staticmeta<(g)>, so reads see writes
+    anymeta_kind::dynamic    the value of dynamic M, e.g. dynameta<T>,
+                             or a copy of a static of a type other than
+                             T, e.g. short g for anymeta<int>
+
+    a() reads with one branch, on the kind: the pointed-to static if
+    indirect, else the value held in place. No heap, no virtual calls;
+    sizeof is that of a T / pointer union plus the kind tag, and it's
+    trivially copyable, as T must be, so passes in registers.
+
+      int g = 4;
+      anymeta<int> a = staticmeta<(g)>{}; // indirect, a() == g
+      anymeta<int> b = staticmeta<8>{};   // constant, b() == 8
+      anymeta<int> c = dynameta<int>{2};  // dynamic,  c() == 2
+
+    a.kind()    -> the anymeta_kind
+    a.address() -> the static's address if indirect, else nullptr
+
+    anymeta is itself a dynamic metavalue, as dynameta.
+
+  * dispatch_static<staticmeta<c...>>(a, f) : recovers a static type
+    from anymeta a, as dispatch_static does from any metavalue, but
+    candidates c may also name statics, by reference, e.g. (g):
+
+      f(staticmeta<(g)>{}) if a is indirect with a.address() == &g
+      f(staticmeta<c>{})   if a is not indirect and a() == c, c constant
+      f(a)                 otherwise, as fallback
+
+      dispatch_static<staticmeta<4,8,(g)>>(a, [](auto n) {...});
+*/
+
+#include "dispatch_static.hpp"
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+enum class anymeta_kind : unsigned char { constant, indirect, dynamic };
+
+namespace impl {
+
+template <anymeta_kind k>
+using anymeta_from = std::integral_constant<anymeta_kind, k>;
+
+// anymeta_kind_of<M,T> : the anymeta_kind that holds a metavalue M as
+//                        value type T; indirect only to a static T
+template <typename M, typename T>
+inline constexpr anymeta_kind anymeta_kind_of
+  = is_metaconst_v<M> ? anymeta_kind::constant
+  : is_metastatic_v<M> && std::is_same_v<T, std::remove_cv_t<
+         std::remove_reference_t<typename M::value_type>>>
+                      ? anymeta_kind::indirect
+                      : anymeta_kind::dynamic;
+
+// anymeta_read(m) : the value of m; of the static if metastatic, as its
+//                   operators are consteval
+template <typename M>
+constexpr decltype(auto) anymeta_read(M const& m) noexcept
+{
+  if constexpr (is_metastatic_v<M>)
+    return (M::value);
+  else
+    return m();
+}
+} // impl
+
+template <typename T>
+struct anymeta
+{
+  static_assert( std::is_trivially_copyable_v<T>
+              && std::is_same_v<T, std::remove_cv_t<T>>
+              && std::is_object_v<T> && ! std::is_array_v<T>,
+        "anymeta value_type must be a trivially copyable object type");
+
+  using value_type = T;
+
+  union {
+    T value;             // the value, unless indirect
+    T const* indirect;   // the static, if indirect
+  };
+  anymeta_kind which{anymeta_kind::dynamic};
+
+  constexpr anymeta() noexcept : value{} {}
+
+  template <typename M, typename = std::enable_if_t<
+                          ! std::is_same_v<M, anymeta>
+                         && is_metavalue_v<M>
+                         && std::is_convertible_v<
+                                      typename M::value_type, T>>>
+  constexpr anymeta(M const& m) noexcept
+    : anymeta(m, impl::anymeta_from<impl::anymeta_kind_of<M,T>>{}) {}
+
+  constexpr T operator()() const noexcept
+  {
+    return which == anymeta_kind::indirect ? *indirect : value;
+  }
+  constexpr operator T() const noexcept { return operator()(); }
+
+  constexpr anymeta_kind kind() const noexcept { return which; }
+  constexpr T const* address() const noexcept
+  {
+    return which == anymeta_kind::indirect ? indirect : nullptr;
+  }
+
+ private:
+  template <typename M>
+  constexpr anymeta(M const&,
+                    impl::anymeta_from<anymeta_kind::constant>) noexcept
+    : value(M::value), which{anymeta_kind::constant} {}
+  template <typename M>
+  constexpr anymeta(M const&,
+                    impl::anymeta_from<anymeta_kind::indirect>) noexcept
+    : indirect(&M::value), which{anymeta_kind::indirect} {}
+  template <typename M>
+  constexpr anymeta(M const& m,
+                    impl::anymeta_from<anymeta_kind::dynamic>) noexcept
+    : value(impl::anymeta_read(m)), which{anymeta_kind::dynamic} {}
+};
+
+namespace impl {
+
+// anymeta_match<c>(a) : a came from candidate c; by address if c is a
+//                       reference, to a static, else by constant value
+template <decltype(auto) c, typename T>
+constexpr bool anymeta_match(anymeta<T> const& a) noexcept
+{
+  if constexpr (std::is_reference_v<decltype(c)>)
+    return a.address() == &c;
+  else
+    return a.kind() != anymeta_kind::indirect && a() == c;
+}
+
+template <typename R, decltype(auto) c0, decltype(auto)...cs,
+          typename T, typename F>
+constexpr R anymeta_call(anymeta<T> const& a, F& f)
+{
+  if (anymeta_match<c0>(a))
+    return f(staticmeta<c0>{});
+  if constexpr (sizeof...(cs) != 0)
+    return anymeta_call<R,cs...>(a, f);
+  else
+    return f(a);
+}
+
+template <typename L> struct anymeta_dispatcher;
+
+template <decltype(auto)...c>
+struct anymeta_dispatcher<staticmeta<c...>>
+{
+  static_assert( (is_metastatic_v<staticmeta<c>> && ...),
+    "dispatch_static anymeta candidates must be constexpr or static");
+
+  template <typename T, typename F>
+  static constexpr decltype(auto) dispatch(anymeta<T> const& a, F& f)
+  {
+    return anymeta_call<decltype(f(a)),c...>(a, f);
+  }
+};
+
+} // impl
+
+// dispatch_static<staticmeta<c...>>(a, f) : f(staticmeta<ci>{}) for
+//              the first candidate ci that anymeta a came from, or f(a)
+template <typename L, typename T, typename F>
+constexpr decltype(auto) dispatch_static(anymeta<T> const& a, F&& f)
+{
+  return impl::anymeta_dispatcher<L>::dispatch(a, f);
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_ASYNC_LOAD_HPP
+#define LML_ASYNC_LOAD_HPP
+
+/*
+  async_load.hpp
+  ==============
+  Asynchronous loading of parameters from a remote config service, in
+  batches of one round trip each, awaited by a coroutine, in place of
+  a blocking fetch per parameter before startup can go on:
+
+  * async_param<T,x...> : a parameter cell that reads its default value
+                          until an override is loaded, then marks ready
+
+    As for a tunable cell, reads are atomic loads, so a service can
+    serve traffic with the defaults while overrides stream in; its id
+    staticmeta<(p)> is a zero-size metastatic parameter. Memory order
+    metadata x... is as for tunable, with acquire the default.
+
+      async_param<int> batch{64};          // 64 until loaded
+      int n = batch();                     // default, or loaded value
+      bool b = batch.ready();
+
+  * param_batch : a list of keys, each with its target and parser
+
+      b.add("batch", batch);               // async_param<T>& target
+      b.add("scale", cfg.scale);           // dynameta<T>& target
+      b.add("window", w, parse_range);     // with a parse function
+
+    Targets are async_param, tunable, dynameta or lazymeta members;
+    parsing is by parse_param<T>, as for load_parameters, or a given
+    parse function. A dynameta target is a plain member; don't read it
+    until the load is done. A lazymeta target takes the loaded value in
+    place of gen(), unless already computed, when it's left as is.
+
+  * load_async(b, fetch) : an awaitable load of batch b, by one call of
+
+      fetch(keys, done)   request the values of keys, a span of
+                          string_view, then call done(values), once,
+                          from any thread, with param_values, a span of
+                          optional string_view values, in key order
+
+    co_await resumes the coroutine from done(), or straight on if done
+    is called before fetch returns, with a param_load count
+    of the loaded, unknown (no value) and invalid (unparsed) keys.
+    Independent batches load concurrently, each a round trip:
+
+      param_load r = co_await load_async(b, fetch);
+
+  The batch must outlive the load. Requires C++20 coroutines.
+*/
+
+#include "lazymeta.hpp"
+#include "registry.hpp"
+#include "tunable.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <span>
+#include <vector>
+
+#if ! __cpp_impl_coroutine
+# error "async_load.hpp requires C++20 coroutines"
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+template <typename T, decltype(auto)...x>
+class async_param
+{
+  static_assert( std::atomic<T>::is_always_lock_free,
+                 "async_param<T> requires lock-free std::atomic<T>");
+
+  std::atomic<T> cell;
+  std::atomic<bool> loaded{false};
+
+ public:
+  using value_type = T;
+
+  // load_order, store_order : from memory_order metadata x..., paired
+  static constexpr std::memory_order load_order
+               = impl::meta_order<std::memory_order_acquire, x...>();
+  static constexpr std::memory_order store_order
+               = impl::store_order(load_order);
+
+  constexpr async_param(T v = T{}) noexcept : cell{v} {}
+
+  async_param(async_param const&) = delete;
+  async_param& operator=(async_param const&) = delete;
+
+  T load() const noexcept { return cell.load(load_order); }
+  T operator()() const noexcept { return load(); }
+  operator T() const noexcept { return load(); }
+
+  bool ready() const noexcept
+  {
+    return loaded.load(std::memory_order_acquire);
+  }
+
+  // set(v) : store the loaded value v, and mark ready
+  void set(T v) noexcept
+  {
+    cell.store(v, store_order);
+    loaded.store(true, std::memory_order_release);
+  }
+};
+
+namespace impl {
+
+// batch_target<X> : the value type and the store of a target, if any
+template <typename X> struct batch_target;
+
+template <typename T, decltype(auto)...x>
+struct batch_target<async_param<T,x...>>
+{
+  using value_type = T;
+  static void store(async_param<T,x...>& p, T const& v) noexcept
+                                                       { p.set(v); }
+};
+template <typename T, decltype(auto)...x>
+struct batch_target<tunable<T,x...>>
+{
+  using value_type = T;
+  static void store(tunable<T,x...>& p, T const& v) noexcept
+                                                     { p.store(v); }
+};
+template <typename T, decltype(auto)...x>
+struct batch_target<dynameta<T,x...>>
+{
+  using value_type = T;
+  static void store(dynameta<T,x...>& p, T const& v) noexcept
+                                                     { p.value = v; }
+};
+template <auto gen>
+struct batch_target<lazymeta<gen>>
+{
+  using value_type = typename lazymeta<gen>::value_type;
+  static void store(lazymeta<gen>& p, value_type const& v) noexcept
+                                                       { p.set(v); }
+};
+
+// batch_entry : a key, its target, and its parser and target loader;
+//               the parser is cast back to param_parser<T> by load
+struct batch_entry
+{
+  using any_parser = void (*)();
+
+  std::string_view key;
+  void* target;
+  any_parser parser;
+  bool (*load)(std::string_view, void*, any_parser) noexcept;
+};
+
+template <typename X>
+bool load_target(std::string_view s, void* target,
+                 batch_entry::any_parser parser) noexcept
+{
+  using T = typename batch_target<X>::value_type;
+  T v{};
+  if (! reinterpret_cast<param_parser<T>>(parser)(s, v))
+    return false;
+  batch_target<X>::store(*static_cast<X*>(target), v);
+  return true;
+}
+
+} // impl
+
+// param_values : the fetched values of a batch, in key order; nullopt
+//                for a key of no value
+using param_values = std::span<std::optional<std::string_view> const>;
+
+class param_batch
+{
+  std::vector<impl::batch_entry> entries;
+  std::vector<std::string_view> keys_;
+
+ public:
+  // add(key, target) : target, of key, parsed by parse_param<T>
+  template <typename X>
+    requires requires { typename impl::batch_target<X>::value_type; }
+  param_batch& add(std::string_view key, X& target)
+  {
+    using T = typename impl::batch_target<X>::value_type;
+    return add(key, target, impl::param_parser<T>{parse_param<T>});
+  }
+
+  // add(key, target, parse) : target, of key, parsed by parse(s, v)
+  template <typename X>
+    requires requires { typename impl::batch_target<X>::value_type; }
+  param_batch& add(std::string_view key, X& target,
+     impl::param_parser<typename impl::batch_target<X>::value_type> p)
+  {
+    entries.push_back({key, &target,
+      reinterpret_cast<impl::batch_entry::any_parser>(p),
+      impl::load_target<X>});
+    keys_.push_back(key);
+    return *this;
+  }
+
+  std::span<std::string_view const> keys() const noexcept
+  {
+    return keys_;
+  }
+  std::size_t size() const noexcept { return entries.size(); }
+  bool empty() const noexcept { return entries.empty(); }
+
+  // fill(values) : parse values, in key order, into their targets
+  param_load fill(param_values values) const noexcept
+  {
+    param_load r{};
+    for (std::size_t i = 0; i != entries.size(); ++i) {
+      auto const& e = entries[i];
+      if (i >= values.size() || ! values[i])
+        ++r.unknown;
+      else if (e.load(*values[i], e.target, e.parser))
+        ++r.loaded;
+      else
+        ++r.invalid;
+    }
+    return r;
+  }
+};
+
+// batch_done : the completion of a batch fetch, called once by fetch
+class batch_done
+{
+  param_batch const* batch;
+  void* context;
+  void (*then)(void*, param_load) noexcept;
+
+ public:
+  batch_done(param_batch const& b, void* c,
+             void (*t)(void*, param_load) noexcept) noexcept
+    : batch{&b}, context{c}, then{t} {}
+
+  void operator()(param_values values) const noexcept
+  {
+    then(context, batch->fill(values));
+  }
+};
+
+// batch_load<Fetch> : the awaitable of load_async
+template <typename Fetch>
+class batch_load
+{
+  param_batch const& batch;
+  Fetch fetch;
+  param_load result{};
+  std::coroutine_handle<> waiter;
+  std::atomic<bool> raced{false}; // set by the first of done, suspend
+
+  // resume : done(); resumes the waiter if await_suspend has returned
+  static void resume(void* self, param_load r) noexcept
+  {
+    auto* const load = static_cast<batch_load*>(self);
+    load->result = r;
+    if (load->raced.exchange(true, std::memory_order_acq_rel))
+      load->waiter.resume();
+  }
+
+ public:
+  batch_load(param_batch const& b, Fetch f)
+    : batch{b}, fetch{std::move(f)} {}
+
+  bool await_ready() const noexcept { return batch.empty(); }
+
+  // The fetch is moved out of the awaiter, as the coroutine may be
+  // resumed, and the awaiter destroyed, before the fetch call returns.
+  // If done is called first then the coroutine isn't suspended
+  bool await_suspend(std::coroutine_handle<> h)
+  {
+    waiter = h;
+    Fetch f = std::move(fetch);
+    f(batch.keys(), batch_done{batch, this, resume});
+    return ! raced.exchange(true, std::memory_order_acq_rel);
+  }
+
+  param_load await_resume() const noexcept { return result; }
+};
+
+// load_async(b, fetch) : an awaitable load of batch b by fetch
+template <typename Fetch>
+batch_load<std::decay_t<Fetch>> load_async(param_batch const& b,
+                                           Fetch&& fetch)
+{
+  return {b, static_cast<Fetch&&>(fetch)};
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_AUTOTUNE_HPP
+#define LML_AUTOTUNE_HPP
+
+/*
+  autotune.hpp
+  ============
+  Autotuning over a compile-time parameter space; the 'going meta' step
+  from dynamic tuning to statically compiled values, automated. Instead
+  of editing a constant, rebuilding and benchmarking, each variant of
+  a kernel is instantiated and timed, then the winner is dispatched to:
+
+  * autotuned<L...> : a tuning space of candidate lists, each L a
+                      staticmeta<c...> of constexpr candidates for one
+                      parameter, e.g. staticmeta<16,32,64,128>, and its
+                      choice of variant, one of the cartesian product
+
+    t.tune(f)           time the variant call f(staticmeta<ci>{}...) of
+                        each combination of candidates ci, best of 5,
+                        and choose the fastest; returns its index
+    t.tune(f, measure)  as tune(f), with the cost of each variant given
+                        by measure(run), where run() calls the variant;
+                        lower is better
+
+    t(f)                call the chosen variant, f(staticmeta<ci>{}...),
+                        by dispatch_static on the choice index
+    t.choice()          index of the chosen variant, in the product
+    t.select(k)         choose variant k, e.g. from an offline run
+    t.chosen<p>()       the chosen candidate value of parameter p
+    t.size()            the number of variants
+
+    The choice is a tunable cell, an atomic static, so a static tuning
+    space can be tuned at startup while workers call t(f); its id is a
+    zero-size metastatic parameter, as for tunable. Before tuning, the
+    choice is variant 0, the first candidate of each list.
+
+      autotuned<staticmeta<16,32,64,128>, staticmeta<1,2,4>> tiles;
+
+      auto kernel = [&](auto tile, auto unroll) { ... };
+      tiles.tune(kernel);              // at startup, or offline
+      tiles(kernel);                   // later calls; one dispatch
+
+  Variants are indexed in row-major order, the last list fastest. All
+  variants must return the same type, as for dispatch_static.
+*/
+
+#include "dispatch_static.hpp"
+#include "tunable.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <utility> // index_sequence
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+template <typename L> struct candidates;
+
+template <decltype(auto) c, decltype(auto)...cs>
+struct candidates<staticmeta<c,cs...>>
+{
+  static_assert( (is_metaconst_v<staticmeta<c>> && ...
+               && is_metaconst_v<staticmeta<cs>>),
+                 "autotuned candidates must be constexpr values");
+
+  static constexpr std::size_t size = 1 + sizeof...(cs);
+
+  template <std::size_t i>
+  using at = meta_at<i, staticmeta<c>, staticmeta<cs>...>;
+};
+
+// stride<p, L...>() : the variant index stride of parameter p
+template <std::size_t p, typename...L>
+constexpr std::size_t stride() noexcept
+{
+  constexpr std::size_t size[]{candidates<L>::size...};
+  std::size_t s = 1;
+  for (std::size_t j = p + 1; j != sizeof...(L); ++j)
+    s *= size[j];
+  return s;
+}
+
+// variant<k, L...> : the candidate types of variant k, as a call of f
+template <std::size_t k, typename...L>
+struct variant
+{
+  template <std::size_t...p, typename F>
+  static constexpr decltype(auto) call(std::index_sequence<p...>, F& f)
+  {
+    return f(typename candidates<L>::template at<
+               k / stride<p, L...>() % candidates<L>::size>{}...);
+  }
+  template <typename F>
+  static constexpr decltype(auto) call(F& f)
+  {
+    return call(std::index_sequence_for<L...>{}, f);
+  }
+};
+
+template <typename> struct index_list;
+template <std::size_t...k>
+struct index_list<std::index_sequence<k...>>
+{
+  using type = staticmeta<k...>;
+};
+
+// keep_sink : the fallback optimization barrier, a volatile store
+inline void const* volatile keep_sink = nullptr;
+
+// keep(v) : an optimization barrier; v, and all memory, are taken as
+//           read and written, so it is neither elided nor hoisted
+template <typename V>
+inline void keep(V const& v) noexcept
+{
+#if defined (__GNUC__) || defined (__clang__)
+  asm volatile("" : : "r"(&v) : "memory");
+#else
+  keep_sink = &v;
+#endif
+}
+
+// kept_run(run) : run(), with its result, if any, kept
+template <typename Run>
+inline void kept_run(Run& run)
+{
+  if constexpr (std::is_void_v<decltype(run())>) {
+    run();
+    keep(run);
+  }
+  else {
+    auto&& result = run();
+    keep(result);
+  }
+}
+
+// best_of<R> : measure, the best of R timed runs after one warm-up,
+//              in nanoseconds; results are kept, so a pure variant is
+//              not optimized out of the timing
+template <int R>
+struct best_of
+{
+  template <typename Run>
+  double operator()(Run& run) const
+  {
+    using clock = std::chrono::steady_clock;
+    kept_run(run);
+    double best = 0;
+    for (int r = 0; r != R; ++r) {
+      auto const start = clock::now();
+      kept_run(run);
+      std::chrono::duration<double, std::nano> t = clock::now() - start;
+      if (r == 0 || t.count() < best)
+        best = t.count();
+    }
+    return best;
+  }
+};
+
+} // impl
+
+template <typename...L>
+class autotuned
+{
+  static_assert( sizeof...(L) != 0, "autotuned needs a candidate list");
+
+  static constexpr std::size_t variants
+              = (std::size_t{1} * ... * impl::candidates<L>::size);
+
+  using indices = typename impl::index_list<
+                             std::make_index_sequence<variants>>::type;
+
+  tunable<std::size_t> choice_{0};
+
+  template <typename F, typename M, std::size_t...k>
+  std::size_t measure_all(F& f, M& measure, std::index_sequence<k...>)
+  {
+    double cost[variants]{};
+    ((cost[k] = [&] {
+      auto run = [&f]() -> decltype(auto) {
+        return impl::variant<k, L...>::call(f);
+      };
+      return double(measure(run));
+    }()), ...);
+    std::size_t won = 0;
+    for (std::size_t i = 1; i != variants; ++i)
+      if (cost[i] < cost[won])
+        won = i;
+    return won;
+  }
+
+ public:
+  autotuned() = default;
+  autotuned(autotuned const&) = delete;
+  autotuned& operator=(autotuned const&) = delete;
+
+  static constexpr std::size_t size() noexcept { return variants; }
+
+  std::size_t choice() const noexcept { return choice_.load(); }
+
+  bool select(std::size_t k) noexcept
+  {
+    if (k >= variants)
+      return false;
+    choice_ = k;
+    return true;
+  }
+
+  template <std::size_t p>
+  auto chosen() const noexcept
+  {
+    using C = impl::candidates<impl::meta_at<p, L...>>;
+    std::size_t const i = choice() / impl::stride<p, L...>() % C::size;
+    return dispatch_static<typename impl::index_list<
+                             std::make_index_sequence<C::size>>::type>(
+      dynameta<std::size_t>{i}, [](auto n) {
+        if constexpr (is_metaconst_v<decltype(n)>)
+          return typename C::template at<decltype(n)::value>{}();
+        else
+          return typename C::template at<0>{}();
+      });
+  }
+
+  template <typename F, typename M>
+  std::size_t tune(F&& f, M&& measure)
+  {
+    std::size_t const won = measure_all(f, measure,
+                                  std::make_index_sequence<variants>{});
+    choice_ = won;
+    return won;
+  }
+  template <typename F>
+  std::size_t tune(F&& f)
+  {
+    return tune(f, impl::best_of<5>{});
+  }
+
+  template <typename F>
+  decltype(auto) operator()(F&& f) const
+  {
+    return dispatch_static<indices>(dynameta<std::size_t>{choice()},
+      [&f](auto k) -> decltype(auto) {
+        if constexpr (is_metaconst_v<decltype(k)>)
+          return impl::variant<decltype(k)::value, L...>::call(f);
+        else  // not reached, the choice is always a variant index
+          return impl::variant<0, L...>::call(f);
+      });
+  }
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
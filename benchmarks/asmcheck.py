@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+# SPDX-License-Identifier: BSL-1.0
+"""
+asmcheck.py : optimized codegen check with FileCheck
+===========
+Compiles a source file to assembly, AT&T syntax, and matches it against
+the CHECK lines in the source itself, as LLVM's lit would:
+
+  asmcheck.py [options] source.cpp -- compiler [compiler-args...]
+
+  --std STD        language standard, e.g. c++20
+  -I DIR           include directory, repeatable
+  -O LEVEL         optimization level (default 2)
+  --filecheck FC   FileCheck executable (default FileCheck)
+
+For gcc or clang; the CHECK lines are written for a target, x86-64.
+"""
+
+import argparse
+import os
+import shlex
+import subprocess
+import sys
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('--std', default='c++20')
+    ap.add_argument('-I', dest='inc', action='append', default=[])
+    ap.add_argument('-O', dest='opt', default='2')
+    ap.add_argument('--filecheck', default='FileCheck')
+    ap.add_argument('source')
+    ap.add_argument('compiler', nargs=argparse.REMAINDER)
+    a = ap.parse_args()
+    compiler = a.compiler[1:] if a.compiler[:1] == ['--'] else a.compiler
+    if not compiler:
+        ap.error('no compiler command given after --')
+    source = os.path.abspath(a.source)
+
+    cmd = (compiler + [f'-std={a.std}', f'-O{a.opt}', '-S', '-o', '-',
+                       '-fno-asynchronous-unwind-tables']
+           + [f'-I{os.path.abspath(i)}' for i in a.inc] + [source])
+    asm = subprocess.run(cmd, capture_output=True)
+    if asm.returncode:
+        sys.exit(f'asmcheck: compile failed: {shlex.join(cmd)}\n'
+                 + asm.stderr.decode(errors='replace'))
+
+    check = subprocess.run([a.filecheck, source], input=asm.stdout)
+    if check.returncode:
+        sys.exit(f'asmcheck: {os.path.basename(source)}: -O{a.opt} '
+                 'codegen does not match its CHECK lines')
+    print(f'{os.path.basename(source)}: -O{a.opt} codegen matches')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+# SPDX-License-Identifier: BSL-1.0
+"""
+codegen.py : codegen parity check of meta and raw functions, any compiler
+==========
+Compiles a source file to assembly, for gcc or clang in AT&T syntax, for
+msvc by /FA in Intel syntax, and checks each extern "C" pair of functions
+NAME_meta and NAME_raw, on x86-64, against the CODEGEN lines in the source:
+
+  // CODEGEN: NAME [loads=N] [stack=0] [insns=N]
+
+  * parity : NAME_meta has the instructions of NAME_raw, by mnemonic and
+             count, and the same loads and stack use, in any order
+  * loads  : the memory reads of NAME_meta, lea and stores not counted
+  * stack  : 0 for no stack pointer or frame pointer use, push or pop
+  * insns  : the instruction count of NAME_meta, with its return
+
+The instruction counts of the NAME_meta functions, their size, are also
+checked against those recorded for the compiler in an --expect file, to
+flag a compiler upgrade that changes them; --update records them.
+
+  codegen.py [options] source.cpp -- compiler [compiler-args...]
+
+  --id ID         compiler id as meson reports it: gcc, clang or msvc
+  --std STD       language standard, e.g. c++20
+  -I DIR          include directory, repeatable
+  -O LEVEL        optimization level (default 2)
+  --expect FILE   JSON of instruction counts, by compiler id then NAME
+  --update        write the counts of this compiler to the --expect file
+
+Exits 77, a meson skip, for other compiler ids.
+"""
+
+import argparse
+import collections
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+
+SKIP = 77
+
+CODEGEN = re.compile(r'//\s*CODEGEN:\s*(\w+)((?:\s+\w+=\d+)*)')
+
+# Instructions that only read the address of their memory operand, or
+# carry no code, when matching instruction lines
+NOLOAD = {'lea', 'leaq', 'leal', 'nop', 'nopl', 'nopw', 'prefetcht0'}
+IGNORE = {'endbr64', 'npad', 'int3'}
+STORE = re.compile(r'^(mov|set|stos|cmov)')  # write their destination
+
+
+def compile_asm(cid, a, source):
+    inc = [os.path.abspath(i) for i in a.inc]
+    compiler = a.compiler
+    if cid == 'msvc':
+        with tempfile.TemporaryDirectory() as tmp:
+            out = os.path.join(tmp, 'codegen.asm')
+            cmd = (compiler + ['/nologo', f'/std:{a.std}', f'/O{a.opt}',
+                               '/EHsc', '/c', '/FA', f'/Fa{out}',
+                               f'/Fo{os.path.join(tmp, "codegen.obj")}']
+                   + [f'/I{i}' for i in inc] + [source])
+            run = subprocess.run(cmd, capture_output=True)
+            text = (open(out, errors='replace').read()
+                    if run.returncode == 0 else '')
+    else:
+        cmd = (compiler + [f'-std={a.std}', f'-O{a.opt}', '-S', '-o', '-',
+                           '-fno-asynchronous-unwind-tables']
+               + [f'-I{i}' for i in inc] + [source])
+        run = subprocess.run(cmd, capture_output=True)
+        text = run.stdout.decode(errors='replace')
+    if run.returncode:
+        sys.exit(f'codegen: compile failed: {shlex.join(cmd)}\n'
+                 + (run.stderr + run.stdout).decode(errors='replace'))
+    return text
+
+
+def split_functions(cid, text, names):
+    """The instruction lines of each function in names, by name"""
+    funcs, cur = {}, None
+    for line in text.splitlines():
+        if cid == 'msvc':
+            code = line.split(';', 1)[0].rstrip()
+            m = re.match(r'^(\w+)\s+(PROC|ENDP)\b', code)
+            if m:
+                cur = m.group(1) if m.group(2) == 'PROC' else None
+                if cur in names:
+                    funcs[cur] = []
+                continue
+        else:
+            code = line.split('#', 1)[0].rstrip()
+            m = re.match(r'^_?([\w.$]+):', code)  # Mach-O prefixes _
+            if m and m.group(1) in names:
+                cur = m.group(1)
+                funcs[cur] = []
+                continue
+            if m and not m.group(1).startswith(('.', 'L')):
+                cur = None                          # another function
+                continue
+            if (re.match(r'^\s*\.size\b|^\.Lfunc_end', code)
+                    or '-- End function' in line):
+                cur = None
+                continue
+        if cur not in funcs:
+            continue
+        code = code.strip()
+        if (not code or code.endswith(':') or code.startswith('.')
+                or code.split()[0] in IGNORE):
+            continue
+        funcs[cur].append(code)
+    return funcs
+
+
+def analyse(cid, insns):
+    """Mnemonic counts, loads and stack use of a list of instructions"""
+    mnemonics = collections.Counter()
+    loads = stack = 0
+    for i in insns:
+        op, args = (re.split(r'\s+', i, 1) + [''])[:2]
+        op = op.lower()
+        mnemonics[op] += 1
+        if (op.startswith(('push', 'pop'))
+                or re.search(r'(?<!\w)%?[re](sp|bp)\b', args, re.I)):
+            stack += 1
+        if op in NOLOAD:
+            continue
+        operands = [o.strip() for o in
+                    re.split(r',(?![^(\[]*[)\]])', args) if o.strip()]
+        if cid == 'msvc':                      # Intel: destination first
+            mem = [k for k, o in enumerate(operands)
+                   if '[' in o or 'PTR' in o]
+            dest = 0
+        else:                                  # AT&T: destination last
+            mem = [k for k, o in enumerate(operands)
+                   if '(' in o or re.match(r'^[A-Za-z_.][\w.@$]*$', o)
+                   and not op.startswith(('j', 'call'))]
+            dest = len(operands) - 1
+        for k in mem:
+            if not (k == dest and len(operands) > 1 and STORE.match(op)):
+                loads += 1
+    return mnemonics, loads, stack
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('--id', default='gcc')
+    ap.add_argument('--std', default='c++20')
+    ap.add_argument('-I', dest='inc', action='append', default=[])
+    ap.add_argument('-O', dest='opt', default='2')
+    ap.add_argument('--expect')
+    ap.add_argument('--update', action='store_true')
+    ap.add_argument('source')
+    ap.add_argument('compiler', nargs=argparse.REMAINDER)
+    a = ap.parse_args()
+    a.compiler = a.compiler[1:] if a.compiler[:1] == ['--'] else a.compiler
+    if not a.compiler:
+        ap.error('no compiler command given after --')
+    if a.id not in ('gcc', 'clang', 'msvc'):
+        print(f'codegen: no assembly parser for compiler id {a.id}')
+        sys.exit(SKIP)
+    source = os.path.abspath(a.source)
+    base = os.path.basename(source)
+
+    checks = {}
+    for m in CODEGEN.finditer(open(source).read()):
+        checks[m.group(1)] = {k: int(v) for k, v in
+                              re.findall(r'(\w+)=(\d+)', m.group(2))}
+    names = {f'{n}_{s}' for n in checks for s in ('meta', 'raw')}
+
+    funcs = split_functions(a.id, compile_asm(a.id, a, source), names)
+    fails, sizes = [], {}
+    for name, want in checks.items():
+        meta, raw = f'{name}_meta', f'{name}_raw'
+        if meta not in funcs or raw not in funcs:
+            fails.append(f'{name}: {meta} or {raw} not found')
+            continue
+        m_ops, m_loads, m_stack = analyse(a.id, funcs[meta])
+        r_ops, r_loads, r_stack = analyse(a.id, funcs[raw])
+        sizes[name] = len(funcs[meta])
+        got = {'loads': m_loads, 'stack': m_stack, 'insns': sizes[name]}
+        if (m_ops, m_loads, m_stack) != (r_ops, r_loads, r_stack):
+            fails.append(f'{name}: meta and raw differ\n  meta: '
+                         + '; '.join(funcs[meta]) + '\n  raw:  '
+                         + '; '.join(funcs[raw]))
+        for k, v in want.items():
+            if got.get(k) != v:
+                fails.append(f'{name}: {k}={got.get(k)}, expected {v}: '
+                             + '; '.join(funcs[meta]))
+
+    if a.expect:
+        expect = (json.load(open(a.expect))
+                  if os.path.exists(a.expect) else {})
+        if a.update:
+            expect[a.id] = dict(sorted(sizes.items()))
+            with open(a.expect, 'w') as f:
+                json.dump(expect, f, indent=2, sort_keys=True)
+                f.write('\n')
+            print(f'codegen: recorded {a.id} sizes in {a.expect}')
+        elif a.id not in expect:
+            print(f'codegen: no recorded {a.id} sizes; run --update')
+        else:
+            for name, n in sorted(sizes.items()):
+                was = expect[a.id].get(name)
+                if was != n:
+                    fails.append(f'{name}: {n} instructions, recorded '
+                                 f'{was}; check the codegen, then --update')
+
+    for f in fails:
+        print(f'codegen: {base}: {f}', file=sys.stderr)
+    if fails:
+        sys.exit(f'codegen: {base}: -O{a.opt} {a.id} codegen fails '
+                 f'{len(fails)} checks')
+    print(f'{base}: -O{a.opt} {a.id} codegen of {len(checks)} meta '
+          'functions matches their raw twins')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,171 @@
+/*
+  codegen_parity.cpp : codegen parity of meta access with raw code
+  ==================
+  Compiled at -O2 by codegen.py, for gcc, clang or msvc, on x86-64.
+  Each extern "C" function NAME_meta uses a meta type and its twin
+  NAME_raw does the same by hand; the two must compile to the same
+  instructions, so with no extra calls, loads or stack traffic. The
+  CODEGEN lines give the expected loads and instructions of NAME_meta:
+
+    loads=N     exactly N memory reads; a metaconst access is 0, an
+                immediate, a metastatic access 1, of its global
+    stack=0     no stack pointer use, push or pop
+    insns=N     the whole function, N instructions with its return
+
+  insns are also recorded, per compiler, in codegen_expect.json, as
+  the size of each function; codegen.py --update rewrites them.
+*/
+
+#include "ray.hpp"
+
+using namespace NAMESPACE_ID;
+
+extern int g;
+extern int const garr[8];
+int twice(int);
+
+constexpr int c = 42;
+
+using ray_c = ray<int*, staticmeta<16>>;
+using ray_s = ray<int*, staticmeta<(g)>>;
+using ray_d = ray<int*, dynameta<int>>;
+
+// The raw twins, of the same layout as their rays
+struct raw_c { int* data; };
+struct raw_s { int* data; };
+struct raw_d { int* data; int extent; };
+
+static_assert( sizeof(ray_c) == sizeof(raw_c)
+            && sizeof(ray_s) == sizeof(raw_s)
+            && sizeof(ray_d) == sizeof(raw_d) );
+
+// makestatic<X>() deduces a metaconst value, or else a static id
+using made_c = decltype(makestatic<c>());
+using made_g = decltype(makestatic<g>());
+using made_a = decltype(makestatic<garr>());
+static_assert( metaconst<made_c> && ! metaconst<made_g>
+            && metastatic<made_g> && metastatic<made_a> );
+
+// The deduction guide deduces a function reference type, T&
+constexpr dynameta fn{twice};
+static_assert( std::is_same_v<decltype(fn),
+                              dynameta<int(&)(int)> const> );
+
+struct raw_fn { int (&f)(int); };
+
+using tagged = staticmeta<1, 'x', c, (g)>;
+
+extern "C" {
+
+// CODEGEN: ray_const_convert loads=0 stack=0 insns=2
+int ray_const_convert_meta(ray_c r) { return r.extent; }
+int ray_const_convert_raw(raw_c) { return 16; }
+
+// CODEGEN: ray_const_call loads=0 stack=0 insns=2
+int ray_const_call_meta(ray_c r) { return r.extent(); }
+int ray_const_call_raw(raw_c) { return 16; }
+
+// CODEGEN: ray_static_convert loads=1 stack=0 insns=2
+int ray_static_convert_meta(ray_s r) { return r.extent; }
+int ray_static_convert_raw(raw_s) { return g; }
+
+// CODEGEN: ray_static_call loads=1 stack=0 insns=2
+int ray_static_call_meta(ray_s r) { return r.extent(); }
+int ray_static_call_raw(raw_s) { return g; }
+
+// CODEGEN: ray_dynamic_convert loads=1 stack=0 insns=2
+int ray_dynamic_convert_meta(ray_d const& r) { return r.extent; }
+int ray_dynamic_convert_raw(raw_d const& r) { return r.extent; }
+
+// CODEGEN: ray_dynamic_call loads=1 stack=0 insns=2
+int ray_dynamic_call_meta(ray_d const& r) { return r.extent(); }
+int ray_dynamic_call_raw(raw_d const& r) { return r.extent; }
+
+// Loops to size(), against loops to the raw extent
+
+// CODEGEN: ray_const_sum stack=0
+int ray_const_sum_meta(ray_c const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != r.size(); ++i)
+    s += r[i];
+  return s;
+}
+int ray_const_sum_raw(raw_c const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != 16; ++i)
+    s += r.data[i];
+  return s;
+}
+
+// CODEGEN: ray_static_sum stack=0
+int ray_static_sum_meta(ray_s const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != r.size(); ++i)
+    s += r[i];
+  return s;
+}
+int ray_static_sum_raw(raw_s const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != static_cast<std::size_t>(g); ++i)
+    s += r.data[i];
+  return s;
+}
+
+// CODEGEN: ray_dynamic_sum stack=0
+int ray_dynamic_sum_meta(ray_d const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != r.size(); ++i)
+    s += r[i];
+  return s;
+}
+int ray_dynamic_sum_raw(raw_d const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != static_cast<std::size_t>(r.extent); ++i)
+    s += r.data[i];
+  return s;
+}
+
+// metaget<I>() of metadata, metaconst and static id
+
+// CODEGEN: metaget_const loads=0 stack=0 insns=2
+int metaget_const_meta() { return tagged::metaget<1>(); }
+int metaget_const_raw() { return c; }
+
+// CODEGEN: metaget_static loads=1 stack=0 insns=2
+int metaget_static_meta() { return tagged::metaget<2>(); }
+int metaget_static_raw() { return g; }
+
+// makestatic-deduced metaconst value and static ids
+
+// CODEGEN: makestatic_const loads=0 stack=0 insns=2
+int makestatic_const_meta() { return made_c{}; }
+int makestatic_const_raw() { return c; }
+
+// CODEGEN: makestatic_static loads=1 stack=0 insns=2
+int makestatic_static_meta() { return made_g{}; }
+int makestatic_static_raw() { return g; }
+
+// CODEGEN: makestatic_array loads=1 stack=0
+int makestatic_array_meta(int i) { return made_a{}()[i]; }
+int makestatic_array_raw(int i) { return garr[i]; }
+
+// Calls through a deduced function reference: direct, or tail, calls
+
+// CODEGEN: fnref_global stack=0
+int fnref_global_meta(int x) { return fn()(x); }
+int fnref_global_raw(int x) { return twice(x); }
+
+// CODEGEN: fnref_member stack=0
+int fnref_member_meta(dynameta<int(&)(int)> const& f, int x)
+{
+  return f()(x);
+}
+int fnref_member_raw(raw_fn const& f, int x) { return f.f(x); }
+
+} // extern "C"
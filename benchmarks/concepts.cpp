@@ -0,0 +1,63 @@
+/*
+  concepts.cpp : compile-time throughput of the meta concepts and traits
+  ============
+  Checks TYPES distinct types of each meta kind against every concept:
+
+    staticmeta<k>          metaconst
+    staticmeta<(g),k>      metastatic, not metaconst
+    dynameta<int,k>        metavalue,  not metastatic
+    typemeta<int,k>        metatype
+
+  -DTRAITS    checks the C++17 is_meta*_v traits instead of concepts
+              (always the case when concepts are not available)
+  -DNOCHECK   instantiates the same types with no checks at all,
+              the baseline to subtract for the per-check cost
+*/
+
+#include "parameta.hpp"
+
+#ifndef TYPES
+#define TYPES 1000
+#endif
+
+using namespace NAMESPACE_ID;
+
+int g;
+
+template <int k> using C = staticmeta<k>;
+template <int k> using S = staticmeta<(g),k>;
+template <int k> using D = dynameta<int,k>;
+template <int k> using T = typemeta<int,k>;
+
+#if defined(TRAITS) || ! __cpp_concepts
+#  define IS(concept,...) is_##concept##_v<__VA_ARGS__>
+#else
+#  define IS(concept,...) concept<__VA_ARGS__>
+#endif
+
+template <int k>
+constexpr bool check()
+{
+#ifdef NOCHECK
+  return sizeof(C<k>) + sizeof(S<k>) + sizeof(D<k>) + sizeof(T<k>) != 0;
+#else
+  return IS(metaconst, C<k>) && IS(metastatic, C<k>) && IS(metavalue, C<k>)
+    && ! IS(metaconst, S<k>) && IS(metastatic, S<k>) && IS(metavalue, S<k>)
+    && ! IS(metaconst, D<k>) &&!IS(metastatic, D<k>) && IS(metavalue, D<k>)
+    && ! IS(metaconst, T<k>) &&!IS(metastatic, T<k>) &&!IS(metavalue, T<k>)
+    && ! IS(metatype, C<k>)  &&!IS(metatype, S<k>)   &&!IS(metatype, D<k>)
+    &&   IS(metatype, T<k>)
+    && IS(metapara, C<k>) && IS(metapara, S<k>) && IS(metapara, D<k>)
+    && IS(metapara, T<k>);
+#endif
+}
+
+template <int...k>
+constexpr bool check_all(std::integer_sequence<int, k...>)
+{
+  return (check<k>() && ...);
+}
+
+static_assert( check_all(std::make_integer_sequence<int,TYPES>{}) );
+
+int main() {}
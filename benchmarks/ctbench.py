@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+# SPDX-License-Identifier: BSL-1.0
+"""
+ctbench.py : compile-time benchmark driver
+==========
+Compiles a source file, syntax-only, once per variant and reports the
+best-of-N wall time, the peak resident set size of the compiler and its
+template instantiation statistics where the compiler can report them:
+
+  clang : -ftime-trace, counts Instantiate{Class,Function} events
+  gcc   : -ftime-report, the 'template instantiation' phase time
+  msvc  : /Bt+, the front-end (c1xx) time
+
+  ctbench.py [options] source.cpp -- compiler [compiler-args...]
+
+  --id ID         compiler id as meson reports it (gcc, clang, ...)
+  --std STD       language standard, e.g. c++20
+  -I DIR          include directory, repeatable
+  --variant N=F   named variant with space-separated extra flags F,
+                  repeatable; default is a single variant 'default'
+  --repeat N      timed runs per variant, best is reported (default 3)
+  --per N         also report the time per unit of work, in microseconds,
+                  for N units over the first variant as a baseline
+"""
+
+import argparse
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+import time
+
+try:
+    import resource  # POSIX only; per-child peak RSS via os.wait4
+except ImportError:
+    resource = None
+
+
+def std_flag(cid, std):
+    return f'/std:{std}' if cid in ('msvc', 'clang-cl') else f'-std={std}'
+
+
+def include_flag(cid, inc):
+    return f'/I{inc}' if cid in ('msvc', 'clang-cl') else f'-I{inc}'
+
+
+def syntax_only(cid):
+    return ['/Zs'] if cid in ('msvc', 'clang-cl') else ['-fsyntax-only']
+
+
+def run(cmd, cwd):
+    """Run cmd; return (wall seconds, peak RSS KiB or None, stderr)"""
+    with tempfile.TemporaryFile() as err:
+        start = time.perf_counter()
+        proc = subprocess.Popen(cmd, cwd=cwd, stdout=err, stderr=err)
+        if resource:
+            _, status, usage = os.wait4(proc.pid, 0)
+            wall = time.perf_counter() - start
+            proc.returncode = os.waitstatus_to_exitcode(status)
+            rss = usage.ru_maxrss // (1024 if sys.platform == 'darwin' else 1)
+        else:
+            proc.wait()
+            wall, rss = time.perf_counter() - start, None
+        err.seek(0)
+        text = err.read().decode(errors='replace')
+    if proc.returncode:
+        sys.exit(f'ctbench: compile failed: {shlex.join(cmd)}\n{text}')
+    return wall, rss, text
+
+
+def instantiations(cid, cwd, stderr):
+    """Instantiation statistic for the last run, as a display string"""
+    if cid == 'clang':
+        count = 0
+        for name in os.listdir(cwd):
+            if name.endswith('.json'):
+                with open(os.path.join(cwd, name)) as f:
+                    events = json.load(f).get('traceEvents', [])
+                count += sum(e.get('name', '').startswith('Instantiate')
+                             for e in events)
+        return f'{count} inst'
+    if cid == 'gcc':
+        # columns: usr ( %) sys ( %) wall ( %) GGC-memory ( %)
+        m = re.search(r'^ *template instantiation *:(.*)$', stderr, re.M)
+        if not m:
+            return '-'
+        times = re.findall(r'(\d+\.\d+) *\( *\d+%\)', m.group(1))
+        ggc = re.search(r'(\d+[kMG]) *\( *\d+%\) *$', m.group(1))
+        return (f'{times[2]} s' if len(times) > 2 else '-') + (
+                f', {ggc.group(1)} GGC' if ggc else '')
+    if cid == 'msvc':
+        m = re.search(r'c1xx\.dll\)=(\d+\.\d+)s', stderr)
+        return f'{m.group(1)} s front-end' if m else '-'
+    return '-'
+
+
+def stats_flags(cid, cwd):
+    if cid == 'clang':  # the trace is written beside the object file
+        return ['-ftime-trace', '-ftime-trace-granularity=0',
+                '-c', '-o', os.path.join(cwd, 'bench.o')]
+    if cid == 'gcc':
+        return ['-ftime-report']
+    if cid == 'msvc':
+        return ['/Bt+']
+    return []
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('--id', default='gcc')
+    ap.add_argument('--std', default='c++20')
+    ap.add_argument('-I', dest='inc', action='append', default=[])
+    ap.add_argument('--variant', action='append', default=[])
+    ap.add_argument('--repeat', type=int, default=3)
+    ap.add_argument('--per', type=int, default=0)
+    ap.add_argument('source')
+    ap.add_argument('compiler', nargs=argparse.REMAINDER)
+    a = ap.parse_args()
+    compiler = a.compiler[1:] if a.compiler[:1] == ['--'] else a.compiler
+    if not compiler:
+        ap.error('no compiler command given after --')
+    source = os.path.abspath(a.source)
+    variants = [v.partition('=')[::2] for v in a.variant] or [('default', '')]
+
+    base = (compiler + [std_flag(a.id, a.std)] + syntax_only(a.id)
+            + [include_flag(a.id, os.path.abspath(i)) for i in a.inc])
+
+    print(f'{os.path.basename(source)} ({a.id} {a.std}, best of {a.repeat})')
+    per = f'{"us/unit":>10}' if a.per else ''
+    print(f'{"variant":<24}{"wall s":>10}{"peak MiB":>10}{per}  instantiation')
+    baseline = None
+    for name, flags in variants:
+        with tempfile.TemporaryDirectory() as cwd:
+            cmd = base + shlex.split(flags)
+            best = min(run(cmd + [source], cwd)[0] for _ in range(a.repeat))
+            stats = stats_flags(a.id, cwd)
+            if '-c' in stats:
+                cmd = [f for f in cmd if f not in syntax_only(a.id)]
+            _, rss, err = run(cmd + stats + [source], cwd)
+            inst = instantiations(a.id, cwd, err)
+        mib = f'{rss / 1024:.1f}' if rss else '-'
+        baseline = best if baseline is None else baseline
+        per = f'{(best - baseline) * 1e6 / a.per:>10.2f}' if a.per else ''
+        print(f'{name:<24}{best:>10.3f}{mib:>10}{per}  {inst}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,131 @@
+/*
+  extent_loops.cpp : runtime benchmark of ray extent kinds
+  ================
+  Sums an int array in a loop bounded by the extent of a ray, for each
+  kind of extent, against the raw loops they should compile to:
+
+    constexpr    for (i < N), N a constexpr int     baseline
+    metaconst    ray<int*, staticmeta<N>>           same code
+    int          for (i < n), n a runtime int       baseline
+    metastatic   ray<int*, staticmeta<(g)>>         one load of g
+    dynameta     ray<int*, dynameta<int>>           one load of extent
+
+  Reports the best of REPEAT runs of REPS sums each, in ns per element,
+  and the ratio to its baseline; a ratio well over 1 is a regression.
+  No dependencies; build with optimization, e.g. -O2.
+*/
+
+#include "ray.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+#ifndef N
+#define N 4096
+#endif
+#ifndef REPS
+#define REPS 2000
+#endif
+#ifndef REPEAT
+#define REPEAT 7
+#endif
+
+using namespace NAMESPACE_ID;
+
+int data[N];
+int g = N;                // the metastatic extent, a static global
+int volatile runtime_n = N;
+
+// clobber(p) : the compiler must assume *p is read and written, so the
+//              sums aren't hoisted out of the repeat loop
+template <typename P> inline void clobber(P p)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  static P volatile sink;
+  sink = p;
+#else
+  asm volatile("" : : "r"(p) : "memory");
+#endif
+}
+
+template <typename R> int sum_ray(R const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != r.size(); ++i)
+    s += r[i];
+  return s;
+}
+
+ray<int*, staticmeta<N>> const rc{data};
+ray<int*, staticmeta<(g)>> const rs{data};
+ray<int*, dynameta<int>> rd{data};
+
+int sum_constexpr()
+{
+  constexpr std::size_t n = N;
+  int s = 0;
+  for (std::size_t i = 0; i != n; ++i)
+    s += data[i];
+  return s;
+}
+int sum_int()
+{
+  std::size_t const n = runtime_n;
+  int s = 0;
+  for (std::size_t i = 0; i != n; ++i)
+    s += data[i];
+  return s;
+}
+int sum_metaconst() { return sum_ray(rc); }
+int sum_metastatic() { return sum_ray(rs); }
+int sum_dynameta() { return sum_ray(rd); }
+
+struct variant {
+  char const* name;
+  int (*sum)();
+  int baseline;   // index of the baseline variant
+  double best;
+};
+
+// measure(v) : ns per element of one run of REPS sums
+double measure(variant const& v)
+{
+  using clock = std::chrono::steady_clock;
+  long check = 0;
+  auto start = clock::now();
+  for (int k = 0; k != REPS; ++k) {
+    clobber(data);
+    check += v.sum();
+  }
+  std::chrono::duration<double, std::nano> t = clock::now() - start;
+  clobber(&check);
+  return t.count() / (double(REPS) * N);
+}
+
+int main()
+{
+  for (int i = 0; i != N; ++i)
+    data[i] = i;
+  rd.extent = {runtime_n};
+
+  variant v[]{{"constexpr", sum_constexpr, 0, 1e300},
+              {"metaconst", sum_metaconst, 0, 1e300},
+              {"int", sum_int, 2, 1e300},
+              {"metastatic", sum_metastatic, 2, 1e300},
+              {"dynameta", sum_dynameta, 2, 1e300}};
+
+  // Round robin, so that clock or load drift hits all variants alike;
+  // the first round, r == -1, is a warm-up
+  for (int r = -1; r != REPEAT; ++r)
+    for (auto& x : v) {
+      double const t = measure(x);
+      if (r >= 0 && t < x.best)
+        x.best = t;
+    }
+
+  std::printf("%-12s %10s %8s   (N=%d, best of %d x %d)\n",
+              "extent", "ns/elem", "ratio", N, REPEAT, REPS);
+  for (auto& x : v)
+    std::printf("%-12s %10.4f %8.2f\n",
+                x.name, x.best, x.best / v[x.baseline].best);
+}
@@ -0,0 +1,114 @@
+/*
+  inline_check.cpp : codegen check that meta value access is free
+  ================
+  Compiled at -O2 to assembly and matched by FileCheck, run by
+  asmcheck.py, for gcc or clang on x86-64. Each extern "C" function
+  reads a ray extent via operator value_type() or operator(), or loops
+  to size(), and must compile to the code of the raw value, inlined:
+
+    metaconst    an immediate, no load
+    metastatic   one load of the static global
+    dynameta     one load of the extent member
+
+  The access counts of "instrument.hpp" are included, and so must be
+  off, for the uncounted types, to compile to exactly the same code.
+*/
+
+#include "ray.hpp"
+#include "instrument.hpp"
+
+using namespace NAMESPACE_ID;
+
+extern int g;
+
+using ray_c = ray<int*, staticmeta<16>>;
+using ray_s = ray<int*, staticmeta<(g)>>;
+using ray_d = ray<int*, dynameta<int>>;
+
+extern "C" {
+
+// The consteval operators of staticmeta are called on rays by value;
+// through a reference parameter the call is not a constant expression
+// without P2280, a C++23 DR; Extent::value and size() still are
+
+// CHECK-LABEL: const_convert:
+// CHECK-NOT:   call
+// CHECK:       movl $16, %eax
+// CHECK-NEXT:  ret
+int const_convert(ray_c r) { return r.extent; }
+
+// CHECK-LABEL: const_call:
+// CHECK-NOT:   call
+// CHECK:       movl $16, %eax
+// CHECK-NEXT:  ret
+int const_call(ray_c r) { return r.extent(); }
+
+// CHECK-LABEL: static_convert:
+// CHECK-NOT:   call
+// CHECK:       movl g(%rip), %eax
+// CHECK-NEXT:  ret
+int static_convert(ray_s r) { return r.extent; }
+
+// CHECK-LABEL: static_call:
+// CHECK-NOT:   call
+// CHECK:       movl g(%rip), %eax
+// CHECK-NEXT:  ret
+int static_call(ray_s r) { return r.extent(); }
+
+// CHECK-LABEL: dynamic_convert:
+// CHECK-NOT:   call
+// CHECK:       movl 8(%rdi), %eax
+// CHECK-NEXT:  ret
+int dynamic_convert(ray_d const& r) { return r.extent; }
+
+// CHECK-LABEL: dynamic_call:
+// CHECK-NOT:   call
+// CHECK:       movl 8(%rdi), %eax
+// CHECK-NEXT:  ret
+int dynamic_call(ray_d const& r) { return r.extent(); }
+
+// Loops to size() have no calls; only the metastatic and dynameta
+// loops load their extent
+
+// CHECK-LABEL: const_sum:
+// CHECK-NOT:   call
+// CHECK-NOT:   g(%rip)
+// CHECK:       ret
+int const_sum(ray_c const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != r.size(); ++i)
+    s += r[i];
+  return s;
+}
+
+// CHECK-LABEL: static_sum:
+// CHECK-NOT:   call
+// CHECK:       g(%rip)
+// CHECK-NOT:   call
+// CHECK:       ret
+int static_sum(ray_s const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != r.size(); ++i)
+    s += r[i];
+  return s;
+}
+
+// CHECK-LABEL: dynamic_sum:
+// CHECK-NOT:   call
+// CHECK:       8(%rdi)
+// CHECK-NOT:   call
+// CHECK:       ret
+int dynamic_sum(ray_d const& r)
+{
+  int s = 0;
+  for (std::size_t i = 0; i != r.size(); ++i)
+    s += r[i];
+  return s;
+}
+
+// CHECK-LABEL: end_of_checks:
+int end_of_checks() { return 0; }
+
+} // extern "C"
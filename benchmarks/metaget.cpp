@@ -0,0 +1,61 @@
+/*
+  metaget.cpp : compile-time benchmark of metadata indexing
+  ===========
+  Instantiates TYPES distinct staticmeta types, each with 40 metadata
+  entries (the size of a number-system format descriptor), then reads
+  every entry by single-index metaget<I>() and all at once by multi-
+  index metaget<I...>(). Compile-only; the cost is all front-end.
+
+  -DMETAGET_BASELINE replaces metaget with the former recursive peel,
+   staticmeta<x...>::metaget<i-1>(), for a before / after comparison.
+*/
+
+#include "parameta.hpp"
+
+#ifndef TYPES
+#define TYPES 64
+#endif
+
+using namespace NAMESPACE_ID;
+
+#define X8(k,j) (k+j),(k+j+1),(k+j+2),(k+j+3),(k+j+4),(k+j+5),(k+j+6),(k+j+7)
+#define X40(k) X8(k,1),X8(k,9),X8(k,17),X8(k,25),X8(k,33)
+
+// Entries differ per type, so no peeled tail is shared between types
+template <int t> using format = staticmeta<t, X40(t*64)>;
+
+#ifdef METAGET_BASELINE
+template <int i, decltype(auto) v, decltype(auto)...x>
+constexpr auto get(staticmeta<v,x...>)
+{
+  if constexpr (i == 0)
+    return staticmeta<staticmeta<x...>{}()>{};
+  else
+    return get<i - 1>(staticmeta<x...>{});
+}
+template <int...i, typename M>
+constexpr auto gets(M m) { return staticmeta<get<i>(m)()...>{}; }
+#else
+template <int i, typename M>
+constexpr auto get(M) { return M::template metaget<i>(); }
+template <int...i, typename M>
+constexpr auto gets(M) { return M::template metaget<i...>(); }
+#endif
+
+template <int t, int...i>
+constexpr bool check(std::integer_sequence<int, i...>)
+{
+  using M = format<t>;
+  return ((get<i>(M{})() == t*64 + i + 1) && ...)
+      && decltype(gets<i...>(M{}))::value == t*64 + 1;
+}
+
+template <int...t>
+constexpr bool check_all(std::integer_sequence<int, t...>)
+{
+  return (check<t>(std::make_integer_sequence<int,40>{}) && ...);
+}
+
+static_assert( check_all(std::make_integer_sequence<int,TYPES>{}) );
+
+int main() {}
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+# SPDX-License-Identifier: BSL-1.0
+"""
+tubench.py : many-TU clean build benchmark, include vs import
+==========
+Generates a synthetic project of N translation units, each using the
+library's meta types and concepts, and times a clean parallel compile
+of all of them, objects only, once per variant:
+
+  include      #include "parameta.hpp" in every TU
+  module       import parameta; after compiling parameta.cppm once
+  header-unit  import "parameta.hpp"; after compiling it once (gcc)
+
+The module build time is included in the module variants' wall time.
+
+  tubench.py [options] parameta.cppm -- compiler [compiler-args...]
+
+  --id ID         compiler id as meson reports it (gcc, clang, msvc)
+  --std STD       language standard, at least c++20
+  -I DIR          include directory, repeatable
+  -D DEF          macro definition for every compile, repeatable;
+                  importers see no module macros, so NAMESPACE_ID is
+                  defined as lml unless given
+  --tus N         translation units to generate (default 64)
+  --jobs J        parallel compiles (default the cpu count)
+  --repeat N      timed clean builds per variant, best is reported
+"""
+
+import argparse
+import concurrent.futures
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+import time
+
+TU = '''\
+#ifdef USE_MODULE
+import parameta;
+#elif defined USE_HEADER_UNIT
+import "parameta.hpp";
+#else
+#include "parameta.hpp"
+#endif
+
+using namespace NAMESPACE_ID;
+
+namespace tu{k} {{
+int g;
+template <int i> using C = staticmeta<i,{k}>;
+template <int i> using S = staticmeta<(g),i,{k}>;
+template <int i> using D = dynameta<int,i,{k}>;
+
+template <int...i>
+constexpr bool check() {{
+  return ((is_metaconst_v<C<i>> && is_metastatic_v<S<i>>
+        && is_metavalue_v<D<i>>
+        && C<i>::template metaget<0>() == {k}) && ...);
+}}
+static_assert( check<0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15>() );
+}}
+int tu{k}_value() {{ return tu{k}::D<{k}>{{{k}}}(); }}
+'''
+
+
+def msvc_like(cid):
+    return cid in ('msvc', 'clang-cl')
+
+
+def module_steps(cid, cppm, cwd):
+    """(interface compile args, importer args) for a named module"""
+    if cid == 'gcc':
+        return (['-fmodules-ts', '-x', 'c++', cppm, '-c',
+                 '-o', os.path.join(cwd, 'parameta.o')],
+                ['-fmodules-ts', '-DUSE_MODULE'])
+    if cid == 'clang':
+        pcm = os.path.join(cwd, 'parameta.pcm')
+        return (['--precompile', '-x', 'c++-module', cppm, '-o', pcm],
+                [f'-fmodule-file=parameta={pcm}', '-DUSE_MODULE'])
+    if cid == 'msvc':
+        ifc = os.path.join(cwd, 'parameta.ifc')
+        return (['/interface', '/TP', cppm, '/c', f'/ifcOutput{ifc}',
+                 '/Fo' + os.path.join(cwd, 'parameta.obj')],
+                ['/reference', f'parameta={ifc}', '/DUSE_MODULE'])
+    return None
+
+
+def header_unit_steps(cid, header):
+    """(header unit compile args, importer args), gcc only;
+    LML_PARAMETA_MODULE selects the importable form of the traits"""
+    if cid == 'gcc':
+        return (['-fmodules-ts', '-DLML_PARAMETA_MODULE',
+                 '-x', 'c++-header', header],
+                ['-fmodules-ts', '-DUSE_HEADER_UNIT'])
+    return None
+
+
+def compile_all(cmd, sources, cwd, jobs):
+    def one(src):
+        obj = os.path.splitext(src)[0] + '.o'
+        out = ['/c', src, '/Fo' + obj] if '/c' in cmd else [src, '-o', obj]
+        return subprocess.run(cmd + out, cwd=cwd, capture_output=True)
+    with concurrent.futures.ThreadPoolExecutor(jobs) as pool:
+        for proc in pool.map(one, sources):
+            if proc.returncode:
+                sys.exit('tubench: compile failed: '
+                         f'{shlex.join(proc.args)}\n'
+                         + proc.stderr.decode(errors='replace'))
+
+
+def build(base, steps, sources, cwd, jobs):
+    """Clean build wall time; interface step, if any, then all TUs"""
+    start = time.perf_counter()
+    if steps:
+        pre, _ = steps
+        proc = subprocess.run(base + pre, cwd=cwd, capture_output=True)
+        if proc.returncode:
+            sys.exit(f'tubench: interface failed: {shlex.join(proc.args)}\n'
+                     + proc.stderr.decode(errors='replace'))
+    compile_all(base + (steps[1] if steps else [])
+                + (['/c'] if '/c' in base else ['-c']), sources, cwd, jobs)
+    return time.perf_counter() - start
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('--id', default='gcc')
+    ap.add_argument('--std', default='c++20')
+    ap.add_argument('-I', dest='inc', action='append', default=[])
+    ap.add_argument('-D', dest='defs', action='append', default=[])
+    ap.add_argument('--tus', type=int, default=64)
+    ap.add_argument('--jobs', type=int, default=os.cpu_count() or 1)
+    ap.add_argument('--repeat', type=int, default=1)
+    ap.add_argument('cppm')
+    ap.add_argument('compiler', nargs=argparse.REMAINDER)
+    a = ap.parse_args()
+    compiler = a.compiler[1:] if a.compiler[:1] == ['--'] else a.compiler
+    if not compiler:
+        ap.error('no compiler command given after --')
+    if a.std == 'c++17':
+        print('tubench: modules need c++20 or later; skipped')
+        return
+    if not any(d.partition('=')[0] == 'NAMESPACE_ID' for d in a.defs):
+        a.defs.append('NAMESPACE_ID=lml')
+    cppm = os.path.abspath(a.cppm)
+    inc = [os.path.abspath(i) for i in a.inc] or [os.path.dirname(cppm)]
+    opt = '/' if msvc_like(a.id) else '-'
+    std = f'/std:{a.std}' if msvc_like(a.id) else f'-std={a.std}'
+    base = (compiler + [std] + [f'{opt}I{i}' for i in inc]
+            + [f'{opt}D{d}' for d in a.defs])
+    if msvc_like(a.id):
+        base += ['/c']
+
+    header = os.path.join(inc[0], 'parameta.hpp')
+    variants = [('include', None),
+                ('module', module_steps(a.id, cppm, '.')),
+                ('header-unit', header_unit_steps(a.id, header))]
+
+    print(f'{a.tus} TUs ({a.id} {a.std}, {a.jobs} jobs,'
+          f' best of {a.repeat})')
+    print(f'{"variant":<24}{"wall s":>10}{"ms/TU":>10}')
+    for name, steps in variants:
+        if name != 'include' and steps is None:
+            print(f'{name:<24}{"-":>10}{"-":>10}  unsupported')
+            continue
+        best = None
+        for _ in range(a.repeat):
+            with tempfile.TemporaryDirectory() as cwd:
+                sources = []
+                for k in range(a.tus):
+                    src = os.path.join(cwd, f'tu{k}.cpp')
+                    with open(src, 'w') as f:
+                        f.write(TU.format(k=k))
+                    sources.append(src)
+                wall = build(base, steps, sources, cwd, a.jobs)
+            best = wall if best is None else min(best, wall)
+        print(f'{name:<24}{best:>10.3f}{best * 1e3 / a.tus:>10.1f}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,268 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_BITPACK_HPP
+#define LML_BITPACK_HPP
+
+/*
+  bitpack.hpp
+  ===========
+  A pack of small dynamic parameters, bit-packed in shared words, in
+  place of a byte or more for each as separate members, plus padding:
+
+  * bits<N> : metadata, the bit width of a dynamic parameter, e.g.
+
+      dynameta<unsigned, bits<5>>    5 bits, 0 to 31
+      dynameta<int, bits<4>>         4 bits, -8 to 7, sign-extended
+      dynameta<mode, bits<3>>        3 bits of an enum
+
+    Without bits<N>, a bool takes 1 bit, other types their full width.
+
+  * bitpack<P...> : each P a metavalue, of integral or enum value type
+                    if dynamic; metastatic parameters take zero bits
+
+    The dynamic fields are laid out in declaration order, each in one
+    word, not straddling two, in one word of the smallest unsigned type
+    that holds them all, else in 64-bit words, e.g.
+
+      using header = bitpack<dynameta<unsigned, bits<3>>,
+                             staticmeta<64>,
+                             dynameta<unsigned, bits<5>>,
+                             dynameta<bool>>;
+      header h{5, 17, true};
+      static_assert( sizeof h == 2 );         // 9 bits, in a uint16_t
+
+  * get<I>(p)      -> the I'th parameter: a dynamic one as a copy of its
+                      metavalue type, extracted by a constant shift and
+                      mask, and a metastatic one as is, with no load
+  * get<Tag>(p)    -> the parameter with metadata typemeta<Tag>{}
+  * set<I>(p, v)   -> store v in the I'th, dynamic, field; and set<Tag>
+
+    A stored value is truncated to the field width, as for bit-fields.
+
+  * p.size()       -> the number of parameters, sizeof...(P)
+  * p.dynamic()    -> the number of stored, dynamic parameters
+
+  Requires C++20 concepts.
+*/
+
+#include "metastruct.hpp"
+
+#include <array>
+#include <climits> // CHAR_BIT
+#include <cstdint> // uint8_t ... uint64_t
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+// bits<N> : metadata, the bit width N of a dynamic bitpack parameter
+template <unsigned N> struct bits_t
+{
+  static constexpr unsigned width = N;
+};
+template <unsigned N> inline constexpr bits_t<N> bits{};
+
+namespace impl {
+
+template <unsigned N>
+constexpr unsigned bits_of(bits_t<N>, unsigned) noexcept { return N; }
+template <typename X>
+constexpr unsigned bits_of(X const&, unsigned b) noexcept { return b; }
+
+// field_value<T> : the integral value type of a field of type T
+template <typename T>
+using field_value = typename std::conditional_t<std::is_enum_v<T>,
+      std::underlying_type<T>, std::type_identity<T>>::type;
+
+// field_bits<P> : the bit width of a stored P, 0 if not storable
+template <typename P> struct field_bits
+{
+  static constexpr unsigned value = 0;
+};
+
+template <typename T, decltype(auto)...x>
+  requires std::is_integral_v<field_value<T>>
+struct field_bits<dynameta<T,x...>>
+{
+  static constexpr unsigned full = std::is_same_v<T, bool> ? 1
+                                 : sizeof(T) * CHAR_BIT;
+  static constexpr unsigned value = [] {
+    unsigned b = full;
+    ((b = bits_of(x, b)), ...);
+    return b;
+  }();
+  static_assert( 0 < value && value <= full,
+                 "bits<N> must be from 1 to the width of the type");
+};
+
+template <typename P>
+concept bit_field = metastatic<P> || field_bits<P>::value != 0;
+
+// bit_words<W,N> : the N storage words, if any, of type W
+template <typename W, std::size_t N>
+struct bit_words
+{
+  W words[N];
+};
+template <typename W>
+struct bit_words<W, 0> {};
+
+// bit_layout<P...> : the word type, and the word and shift of each P
+template <typename...P>
+struct bit_layout
+{
+  static constexpr unsigned width[]{(metastatic<P>
+                                     ? 0 : field_bits<P>::value)..., 0};
+  static constexpr unsigned total = (0u + ... + (metastatic<P>
+                                     ? 0 : field_bits<P>::value));
+
+  using word = std::conditional_t<total <= 8, std::uint8_t,
+               std::conditional_t<total <= 16, std::uint16_t,
+               std::conditional_t<total <= 32, std::uint32_t,
+                                               std::uint64_t>>>;
+  static constexpr unsigned word_bits = sizeof(word) * CHAR_BIT;
+
+  struct place
+  {
+    std::size_t word;
+    unsigned shift;
+  };
+
+  static constexpr auto places = [] {
+    std::array<place, sizeof...(P) + 1> p{};
+    std::size_t w = 0;
+    unsigned used = 0;
+    for (std::size_t i = 0; i != sizeof...(P); ++i) {
+      if (width[i] == 0)
+        continue;
+      if (used + width[i] > word_bits) {
+        ++w;
+        used = 0;
+      }
+      p[i] = {w, used};
+      used += width[i];
+    }
+    p[sizeof...(P)] = {total ? w + 1 : 0, 0};
+    return p;
+  }();
+
+  static constexpr std::size_t words = places[sizeof...(P)].word;
+
+  using storage = bit_words<word, words>;
+};
+
+// load_field<I,P...>(w) : the value of the I'th field of words w
+template <std::size_t I, typename...P, typename W, std::size_t N>
+constexpr auto load_field(bit_words<W,N> const& w) noexcept
+{
+  using L = bit_layout<P...>;
+  using T = typename meta_at<I, P...>::value_type;
+  using V = field_value<T>;
+  constexpr unsigned n = L::width[I];
+  constexpr unsigned shift = L::places[I].shift;
+  constexpr std::uint64_t mask = n == 64 ? ~std::uint64_t{}
+                                         : (std::uint64_t{1} << n) - 1;
+
+  std::uint64_t const u = w.words[L::places[I].word];
+  if constexpr (std::is_same_v<T, bool>)
+    return ((u >> shift) & mask) != 0;
+  else if constexpr (std::is_signed_v<V>)   // sign-extended, by shifts
+    return static_cast<T>(static_cast<V>(
+      static_cast<std::int64_t>(u << (64 - shift - n)) >> (64 - n)));
+  else
+    return static_cast<T>(static_cast<V>((u >> shift) & mask));
+}
+
+// store_field<I,P...>(w, v) : store v, truncated, in the I'th field
+template <std::size_t I, typename...P, typename W, std::size_t N>
+constexpr void store_field(bit_words<W,N>& w,
+              typename meta_at<I, P...>::value_type v) noexcept
+{
+  using L = bit_layout<P...>;
+  using V = field_value<typename meta_at<I, P...>::value_type>;
+  constexpr unsigned n = L::width[I];
+  constexpr unsigned shift = L::places[I].shift;
+  constexpr std::uint64_t mask = (n == 64 ? ~std::uint64_t{}
+                               : (std::uint64_t{1} << n) - 1) << shift;
+
+  W& word = w.words[L::places[I].word];
+  word = static_cast<W>((std::uint64_t{word} & ~mask)
+       | ((static_cast<std::uint64_t>(static_cast<V>(v)) << shift)
+          & mask));
+}
+
+} // impl
+
+template <metavalue...P>
+  requires (impl::bit_field<P> && ...)
+struct bitpack : impl::bit_layout<P...>::storage
+{
+  using layout = impl::bit_layout<P...>;
+
+  static constexpr std::size_t size() noexcept { return sizeof...(P); }
+  static constexpr std::size_t dynamic() noexcept
+                     { return (std::size_t{0} + ... + !metastatic<P>); }
+
+  constexpr bitpack() = default;
+
+  template <typename...D>
+    requires (sizeof...(D) == dynamic() && sizeof...(D) != 0)
+  constexpr bitpack(D const&...dyn) noexcept
+    : layout::storage{}
+  {
+    [&]<std::size_t...i>(std::index_sequence<i...>) {
+      (init<i>(std::forward_as_tuple(dyn...)), ...);
+    }(std::make_index_sequence<sizeof...(P)>{});
+  }
+
+ private:
+  template <std::size_t i, typename Tuple>
+  constexpr void init(Tuple const& dyn) noexcept
+  {
+    using P_i = impl::meta_at<i, P...>;
+    if constexpr (! metastatic<P_i>)
+      impl::store_field<i, P...>(*this,
+        static_cast<typename P_i::value_type>(
+          std::get<impl::dynamic_rank<P...>(i)>(dyn)));
+  }
+};
+
+// get<I>(p) : the I'th parameter of bitpack p, by value
+template <std::size_t I, typename...P>
+constexpr auto get(bitpack<P...> const& p) noexcept
+{
+  using P_I = impl::meta_at<I, P...>;
+  if constexpr (metastatic<P_I>)
+    return P_I{};
+  else
+    return P_I{impl::load_field<I, P...>(p)};
+}
+
+// get<Tag>(p) : the parameter of bitpack p tagged typemeta<Tag>{}
+template <typename Tag, typename...P>
+constexpr auto get(bitpack<P...> const& p) noexcept
+{
+  return get<impl::tag_index<Tag, P...>()>(p);
+}
+
+// set<I>(p, v) : store v in the I'th, dynamic, field of bitpack p
+template <std::size_t I, typename...P>
+  requires (! metastatic<impl::meta_at<I, P...>>)
+constexpr void set(bitpack<P...>& p,
+                typename impl::meta_at<I, P...>::value_type v) noexcept
+{
+  impl::store_field<I, P...>(p, v);
+}
+
+// set<Tag>(p, v) : store v in the field of bitpack p tagged Tag
+template <typename Tag, typename...P, typename V>
+constexpr void set(bitpack<P...>& p, V const& v) noexcept
+{
+  set<impl::tag_index<Tag, P...>()>(p, v);
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
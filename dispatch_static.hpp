@@ -0,0 +1,126 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_DISPATCH_STATIC_HPP
+#define LML_DISPATCH_STATIC_HPP
+
+/*
+  dispatch_static.hpp
+  ===================
+  Runtime-to-static dispatch; promotes a runtime meta value to one of a
+  list of compile-time candidate values, for 'generic staticity' at run
+  time: the callee is instantiated for each constant candidate so gets
+  constexpr values to fold, unroll and vectorize, while only the caller
+  pays for the one branch.
+
+  * dispatch_static<L>(d, f) -> f(staticmeta<c>{}) if d() == c
+                                else f(d)
+
+    L = staticmeta<c0,c1...> lists the candidate constants (value and
+        metadata together, as a list of constexpr values)
+    d is a metavalue, e.g. dynameta<int>, read once
+    f is called with the matching staticmeta<c>, or with d as fallback;
+      the result is converted to the fallback return type R = f(d)
+
+    If d is metaconst then f(d) is called directly, with no branch.
+
+  Candidates of the value type of d, more than two, distinct, integral
+  or enum, index a table of function pointers, one per candidate, plus
+  the fallback, by the metatable.hpp lookup: by d() - min if the values
+  span a small range, else by binary search of the sorted values. Other
+  candidates are compared in order by equality.
+
+  Example:
+
+    dynameta<int> extent{read_config()};
+    dispatch_static<staticmeta<4,8,16>>(extent, [&](auto n) {
+      for (int i = 0; i != n(); ++i) ... // constant trip count 4, 8, 16
+    });                                  //       or dynamic extent()
+*/
+
+#include "metatable.hpp"
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+template <typename L> struct dispatcher;
+
+template <decltype(auto)...c>
+struct dispatcher<staticmeta<c...>>
+{
+  static_assert( (is_metaconst_v<staticmeta<c>> && ...),
+                 "dispatch_static candidates must be constexpr values");
+
+  // call<R,c0,c...>(v,d,f) : f(staticmeta<c0>) if v == c0, else the rest
+  template <typename R, decltype(auto) c0, decltype(auto)...cs,
+            typename V, typename D, typename F>
+  static constexpr R call(V const& v, D const& d, F& f)
+  {
+    if (v == c0)
+      return f(staticmeta<c0>{});
+    if constexpr (sizeof...(cs) != 0)
+      return call<R,cs...>(v, d, f);
+    else
+      return f(d);
+  }
+
+  // indexed<V>() : the candidates key a table, by a V value
+  template <typename V>
+  static constexpr bool indexed() noexcept
+  {
+    if constexpr (sizeof...(c) > 2 && hashable_key<V>
+          && (std::is_same_v<V, std::remove_cv_t<decltype(c)>> && ...))
+      return distinct(meta_array<c...>::value);
+    else
+      return false;
+  }
+
+  // jump<R,D,F>::table : f(staticmeta<c>) per candidate, then f(d)
+  template <typename R, typename D, typename F>
+  struct jump
+  {
+    template <decltype(auto) ci>
+    static constexpr R to(D const&, F& f)
+                                         { return f(staticmeta<ci>{}); }
+    static constexpr R fallback(D const& d, F& f) { return f(d); }
+
+    static constexpr R (*const table[])(D const&, F&)
+                                              = {&to<c>..., &fallback};
+  };
+
+  template <typename D, typename F>
+  static constexpr decltype(auto) dispatch(D const& d, F& f)
+  {
+    using R = decltype(f(d));
+    using V = std::remove_cv_t<std::remove_reference_t<decltype(d())>>;
+    if constexpr (is_metaconst_v<D>)
+      return f(d);
+    else if constexpr (indexed<V>()) {
+      using keys = meta_array<c...>;
+      using index = key_table<keys, unhashed_plan_of<keys>>;
+      return jump<R,D,F>::table[index::index(d())](d, f);
+    }
+    else
+      return call<R,c...>(d(), d, f);
+  }
+};
+
+} // impl
+
+// dispatch_static<staticmeta<c...>>(d, f) : f(staticmeta<ci>{}) for the
+//                          first candidate ci equal to d(), else f(d)
+template <typename L, typename D, typename F>
+constexpr decltype(auto) dispatch_static(D const& d, F&& f)
+{
+  static_assert( is_metavalue_v<D>,
+                 "dispatch_static argument must be a metavalue");
+  return impl::dispatcher<L>::dispatch(d, f);
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,276 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_INSTRUMENT_HPP
+#define LML_INSTRUMENT_HPP
+
+/*
+  instrument.hpp
+  ==============
+  Opt-in counts of the runtime accesses of metavalue parameters, to find
+  the hot ones, e.g. those worth making static; off, the value access
+  operators compile to exactly the code they do uninstrumented:
+
+  * counted : a metadata tag that turns on the counts of its type
+
+      dynameta<int, counted> threads{8};
+      using batch = staticmeta<(batch_size), counted>;
+
+  * LML_PARAMETA_INSTRUMENT : a configuration macro that turns on the
+                              counts of all dynameta and metastatic ids
+
+    If defined, "parameta.hpp" includes this header at its end, in
+    C++20; C++17 access is never counted. As for LML_PARAMETA_EXTERN,
+    every TU of a program must agree on it, e.g. by the meson option
+    'instrument'. Not for the named module.
+
+  Accesses through operator() and operator value_type() are counted,
+  not reads of M::value or of the value member, and not in constant
+  evaluation. A counted staticmeta id's operators are then constexpr,
+  not consteval. metaconst types aren't counted, having no runtime
+  access to count.
+
+  Counts are per thread, in a cache-line aligned block of relaxed atomic
+  counters per thread, so a count is a plain increment with no sharing,
+  and are summed on demand, over the live threads and those exited;
+  counts by a thread after its block is retired, at exit, are lost.
+  Counts from static initializers are kept, each type's counter slot
+  being assigned on its first count:
+
+  * access_counts() -> vector of {name, count}, per counted type
+  * accesses<M>()   -> the count of counted type M
+
+  The name is the type name, as given by the compiler. There are
+  LML_PARAMETA_ACCESS_SLOTS counters per thread, default 256, one per
+  counted type; types past the last but one share the last, reported
+  as "(other)".
+  Requires C++20 concepts.
+*/
+
+#include "parameta.hpp"
+
+#include <atomic>
+#include <cstdint>     // uint64_t
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#if ! __cpp_concepts
+# error "instrument.hpp requires C++20 concepts"
+#endif
+
+#ifndef LML_PARAMETA_ACCESS_SLOTS
+#define LML_PARAMETA_ACCESS_SLOTS 256
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+// counted : metadata tag, to count the accesses of its metavalue type
+struct counted_t {};
+inline constexpr counted_t counted{};
+
+namespace impl {
+
+template <decltype(auto)...x>
+inline constexpr bool is_counted =
+   (std::is_same_v<std::remove_cvref_t<decltype(x)>, counted_t> || ...);
+
+#ifdef LML_PARAMETA_INSTRUMENT
+inline constexpr bool count_all = true;
+#else
+inline constexpr bool count_all = false;
+#endif
+
+inline constexpr std::size_t access_slots = LML_PARAMETA_ACCESS_SLOTS;
+static_assert( access_slots > 1, "too few access counter slots" );
+
+// access_block : the counters of a thread, alone in its cache lines
+struct alignas(64) access_block
+{
+  std::atomic<std::uint64_t> n[access_slots]{};
+  access_block* next = nullptr;
+};
+
+// access_site : a counted type, its name and its counter slot
+struct access_site
+{
+  std::string_view name;
+  std::size_t slot;
+  access_site* next;
+
+  explicit access_site(std::string_view n) noexcept;
+};
+
+// access_state : the registry of sites and thread blocks, and the sums
+//                of the counts of exited threads
+struct access_state
+{
+  std::mutex m;
+  access_site* sites = nullptr;
+  std::size_t used = 0;
+  bool shared = false;         // the last slot, by the overflow sites
+  access_block* blocks = nullptr;
+  std::uint64_t retired[access_slots]{};
+};
+
+inline constinit access_state access_registry{};
+
+// access_discard : the block of the threads whose own is retired; its
+//                  counts, relaxed and unsynchronized, are never read
+inline constinit access_block access_discard{};
+
+// access_owner : the block of a thread, linked in the registry while
+//                the thread lives, and its counts retired on exit
+struct access_owner
+{
+  access_block block;
+
+  access_owner() noexcept
+  {
+    auto& r = access_registry;
+    std::lock_guard lock(r.m);
+    block.next = r.blocks;
+    r.blocks = &block;
+  }
+  ~access_owner();
+  access_owner(access_owner const&) = delete;
+  access_owner& operator=(access_owner const&) = delete;
+};
+
+inline access_site::access_site(std::string_view n) noexcept : name{n}
+{
+  auto& r = access_registry;
+  std::lock_guard lock(r.m);
+  r.shared = r.shared || r.used == access_slots - 1;
+  slot = r.shared ? access_slots - 1 : r.used++;
+  next = r.sites;
+  r.sites = this;
+}
+
+// thread_block : this thread's block, once attached; constant
+//                initialized, so read with no TLS init call
+inline constinit thread_local access_block* thread_block = nullptr;
+
+// ~access_owner : on thread exit, later counts go to access_discard,
+//                 not through thread_block to the destroyed block
+inline access_owner::~access_owner()
+{
+  thread_block = &access_discard;
+  auto& r = access_registry;
+  std::lock_guard lock(r.m);
+  for (std::size_t i = 0; i != access_slots; ++i)
+    r.retired[i] += block.n[i].load(std::memory_order_relaxed);
+  access_block** b = &r.blocks;
+  while (*b != &block)
+    b = &(*b)->next;
+  *b = block.next;
+}
+
+inline access_block* attach_thread() noexcept
+{
+  static thread_local access_owner owner;
+  return thread_block = &owner.block;
+}
+
+// count_in(slot) : this thread's count, with no read-modify-write, as
+//                  only this thread writes it
+inline void count_in(std::size_t slot) noexcept
+{
+  access_block* b = thread_block;
+  if (! b) [[unlikely]]
+    b = attach_thread();
+  auto& c = b->n[slot];
+  c.store(c.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+}
+
+// sum_of(slot) : the count of slot, over all threads; lock held
+inline std::uint64_t sum_of(std::size_t slot) noexcept
+{
+  std::uint64_t s = access_registry.retired[slot];
+  for (access_block* b = access_registry.blocks; b; b = b->next)
+    s += b->n[slot].load(std::memory_order_relaxed);
+  return s;
+}
+
+template <typename M>
+std::string_view access_name() noexcept
+{
+#if defined (_MSC_VER) && ! defined (__clang__)
+  std::string_view f = __FUNCSIG__;
+  auto const b = f.find("access_name<") + 12;
+  auto const e = f.rfind(">(void)");
+#else
+  std::string_view f = __PRETTY_FUNCTION__;
+  auto const b = f.find("M = ") + 4;
+  auto e = f.find(';', b);
+  if (e == f.npos)
+    e = f.rfind(']');
+#endif
+  return f.substr(b, e - b);
+}
+
+// site_of<M>() : the site of counted type M, registered on first use,
+//                so in order for counts from any static initializer
+template <typename M>
+access_site& site_of() noexcept
+{
+  static access_site site{access_name<M>()};
+  return site;
+}
+
+template <typename M>
+struct access_counter
+{
+  static void count() noexcept { count_in(site_of<M>().slot); }
+};
+
+template <typename T, decltype(auto)...x>
+  requires (count_all || is_counted<x...>)
+inline constexpr bool access_counted<dynameta<T,x...>> = true;
+
+// Only static ids; metaconst values have no runtime access
+template <decltype(auto) v, decltype(auto)...x>
+  requires std::is_lvalue_reference_v<decltype(v)>
+        && (count_all || is_counted<x...>)
+inline constexpr bool access_counted<staticmeta<v,x...>> = true;
+
+} // impl
+
+// access_count : the name of a counted type and its count of accesses
+struct access_count
+{
+  std::string_view name;
+  std::uint64_t count;
+};
+
+// access_counts() : the counts of all counted types, summed on demand
+inline std::vector<access_count> access_counts()
+{
+  auto& r = impl::access_registry;
+  std::vector<access_count> counts;
+  std::lock_guard lock(r.m);
+  for (auto* s = r.sites; s; s = s->next)
+    if (s->slot != impl::access_slots - 1)
+      counts.insert(counts.begin(), {s->name, impl::sum_of(s->slot)});
+  if (r.shared)
+    counts.push_back({"(other)", impl::sum_of(impl::access_slots - 1)});
+  return counts;
+}
+
+// accesses<M>() : the count of counted type M, summed on demand
+template <typename M>
+  requires impl::access_counted<M>
+std::uint64_t accesses()
+{
+  std::size_t const slot = impl::site_of<M>().slot; // may lock, once
+  std::lock_guard lock(impl::access_registry.m);
+  return impl::sum_of(slot);
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
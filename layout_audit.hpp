@@ -0,0 +1,197 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_LAYOUT_AUDIT_HPP
+#define LML_LAYOUT_AUDIT_HPP
+
+/*
+  layout_audit.hpp
+  ================
+  Compile-time layout report, a sizeof and padding audit, of classes
+  built from metavalue members, e.g. ray, mdray, number, metastruct;
+  for static_assert checks of their cache footprint:
+
+  * layout_audit<C,M...> : layout of class C, given the types M... of
+                           its members, or bases, in declaration order
+
+    size, align        sizeof(C), alignof(C)
+    dynamic_members    the number of non-empty M, that take storage
+    dynamic_bytes      their total size; a reference counts as a pointer
+    static_members     the number of empty M, e.g. metastatic members,
+                       that should be zero-size
+    padding            size - dynamic_bytes
+    packed_size        the size of C if the empty M take no storage,
+                       with the non-empty M laid out in order, aligned
+    overhead           size - packed_size, bytes taken by empty members
+    zero_size          overhead == 0; [[no_unique_address]] or EBO took
+                       effect for all the empty members
+    sorted_size        packed_size with the non-empty members sorted by
+                       decreasing alignment, a lower bound for reorder
+
+  An empty class has size 1, counted as padding.
+
+  zero_size is false if the compiler ignores [[no_unique_address]]
+  (MSVC does, without [[msvc::no_unique_address]]), or if two empty
+  members of the same type need distinct addresses.
+
+  * layout_audit_of<C> : layout_audit of a library class C, e.g.
+
+      using ps = layout_audit_of<ray<char*, dynameta<int>>>;
+      static_assert( ps::size == 16 && ps::padding == 4 );
+      static_assert( layout_audit_of<ray<char*, staticmeta<4>>>
+                     ::zero_size );
+
+  Requires C++20 concepts.
+*/
+
+#include "mdray.hpp"
+#include "number.hpp"
+#include "metastruct.hpp"
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// stored<M> : the type stored for a member of type M; a pointer for a
+//             reference, as for ray member_align
+template <typename M> using stored = std::conditional_t<
+       std::is_reference_v<M>, std::remove_reference_t<M>*, M>;
+
+template <typename M> inline constexpr bool takes_storage
+                                     = ! std::is_empty_v<stored<M>>;
+
+constexpr std::size_t align_up(std::size_t n, std::size_t a) noexcept
+{
+  return (n + a - 1) / a * a;
+}
+
+// packed_size<M...>(align, sorted) : size of the non-empty M... laid
+//                out in order, or by decreasing alignment if sorted
+template <typename...M>
+constexpr std::size_t packed_size(std::size_t align, bool sorted)
+                                                              noexcept
+{
+  constexpr std::size_t n = sizeof...(M);
+  std::size_t const size[]{sizeof(stored<M>)..., 0};
+  std::size_t const algn[]{alignof(stored<M>)..., 1};
+  bool const dyn[]{takes_storage<M>..., false};
+
+  std::size_t order[n + 1]{}, k = 0;
+  for (std::size_t i = 0; i != n; ++i) {
+    if (! dyn[i])
+      continue;
+    std::size_t j = k++;
+    for (; sorted && j != 0 && algn[order[j-1]] < algn[i]; --j)
+      order[j] = order[j-1];
+    order[j] = i;
+  }
+  std::size_t offset = 0;
+  for (std::size_t j = 0; j != k; ++j)
+    offset = align_up(offset, algn[order[j]]) + size[order[j]];
+  return align_up(offset ? offset : 1, align);
+}
+
+} // impl
+
+template <typename C, typename...M>
+struct layout_audit
+{
+  static constexpr std::size_t size = sizeof(C);
+  static constexpr std::size_t align = alignof(C);
+
+  static constexpr std::size_t dynamic_members
+                    = (std::size_t{0} + ... + impl::takes_storage<M>);
+  static constexpr std::size_t dynamic_bytes
+                    = (std::size_t{0} + ... + (impl::takes_storage<M>
+                                        ? sizeof(impl::stored<M>) : 0));
+  static constexpr std::size_t static_members
+                    = sizeof...(M) - dynamic_members;
+
+  static constexpr std::size_t padding = size - dynamic_bytes;
+
+  static constexpr std::size_t packed_size
+                    = impl::packed_size<M...>(align, false);
+  static constexpr std::size_t overhead = size - packed_size;
+  static constexpr bool zero_size = overhead == 0;
+
+  static constexpr std::size_t sorted_size
+                    = impl::packed_size<M...>(align, true);
+};
+
+namespace impl {
+
+template <typename C> struct audit;
+
+template <typename S, typename E>
+struct audit<ray<S,E>>
+{
+  using type = layout_audit<ray<S,E>, S, E>;
+};
+
+template <typename S, typename X, typename L>
+struct audit<mdray<S,X,L>>
+{
+  using type = layout_audit<mdray<S,X,L>, S, X>;
+};
+
+template <typename...E>
+struct audit<extents<E...>>
+{
+  using type = layout_audit<extents<E...>, E...>;
+};
+
+template <typename W, typename B, typename E>
+struct audit<number<W,B,E>>
+{
+  using type = layout_audit<number<W,B,E>, W, B, E,
+                            typename number<W,B,E>::code_type>;
+};
+
+// static_order<P...>() : indices of the metastatic P..., in order
+template <typename...P>
+constexpr auto static_order() noexcept
+{
+  constexpr bool stat[]{metastatic<P>..., false};
+  std::array<std::size_t, (std::size_t{0} + ... + metastatic<P>)> o{};
+  for (std::size_t i = 0, k = 0; i != sizeof...(P); ++i)
+    if (stat[i])
+      o[k++] = i;
+  return o;
+}
+
+// metastruct_audit : the dynamic P..., in packing order, then the
+//                    metastatic P..., which aren't stored
+template <typename, typename, typename...P> struct metastruct_audit;
+
+template <std::size_t...d, std::size_t...s, typename...P>
+struct metastruct_audit<std::index_sequence<d...>,
+                        std::index_sequence<s...>, P...>
+{
+  static constexpr auto dyn = packing_order<P...>();
+  static constexpr auto stat = static_order<P...>();
+  using type = layout_audit<metastruct<P...>,
+                            meta_at<dyn[d], P...>...,
+                            meta_at<stat[s], P...>...>;
+};
+
+template <typename...P>
+struct audit<metastruct<P...>>
+{
+  using type = typename metastruct_audit<
+    std::make_index_sequence<packing_order<P...>().size()>,
+    std::make_index_sequence<static_order<P...>().size()>, P...>::type;
+};
+
+} // impl
+
+// layout_audit_of<C> : layout_audit of ray, mdray, extents, number or
+//                      metastruct C, with its member types
+template <typename C>
+using layout_audit_of = typename impl::audit<C>::type;
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_LAZYMETA_HPP
+#define LML_LAZYMETA_HPP
+
+/*
+  lazymeta.hpp
+  ============
+  Deferred-initialization dynamic metavalue; dynameta<T> takes its value
+  at initialization, so an expensive parameter, e.g. probed cache sizes
+  or CPU topology, is paid for at startup even if never read. Instead:
+
+  * lazymeta<gen> : a dynamic metavalue whose value is gen(), computed
+                    on first access, once, then held as for dynameta
+
+    gen is a constexpr callable, a function pointer or, from C++20, a
+    captureless lambda; value_type is the unqualified type of gen().
+
+    Access is by the metavalue API, operator()() or conversion; the
+    first reader computes the value while concurrent first readers
+    wait for it, by a one-time atomic init state, so there's no race.
+    Later reads are an acquire load of the state and a load of value.
+    If gen() throws, the state is reset, for the next reader to retry.
+
+    The constructor is constexpr, so a static lazymeta is constant
+    initialized, with no startup cost; its static id, staticmeta<(l)>,
+    is a zero-size metastatic parameter, whose value converts to T,
+    computed on first read, as for a tunable cell:
+
+      int probe_l2() { ... }           // expensive
+      lazymeta<probe_l2> l2;           // nothing computed yet
+
+      int n = l2();                    // computes probe_l2(), once
+      using l2_t = staticmeta<(l2)>;   // metastatic, zero size
+      int m = l2_t{}();                // lazymeta const&, converts
+
+    lazymeta<gen>{v} is initialized to v, as if gen() were computed.
+    l.set(v) sets v so, unless the value is computed, or computing, and
+    tells if it did. l.ready() tells if the value is yet computed.
+
+  The 'value' data member is only valid once ready(); access the value
+  via operator()() or conversion, which compute it if need be.
+*/
+
+#include "parameta.hpp"
+
+#include <atomic>
+#if ! __cpp_lib_atomic_wait
+# include <thread> // this_thread::yield, to wait on a first reader
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// lazy_state : the one-time init state of a lazymeta
+enum lazy_state : unsigned char { lazy_idle, lazy_busy, lazy_ready };
+
+// lazy_unwind : on exit from the init of a lazymeta, stores its state,
+//               back to idle unless set ready, and wakes any waiters
+struct lazy_unwind
+{
+  std::atomic<unsigned char>& state;
+  unsigned char to = lazy_idle;
+  ~lazy_unwind()
+  {
+    state.store(to, std::memory_order_release);
+#if __cpp_lib_atomic_wait
+    state.notify_all();
+#endif
+  }
+};
+
+inline void lazy_wait(std::atomic<unsigned char> const& state) noexcept
+{
+#if __cpp_lib_atomic_wait
+  state.wait(lazy_busy, std::memory_order_acquire);
+#else
+  (void)state;
+  std::this_thread::yield();
+#endif
+}
+
+} // impl
+
+template <auto gen>
+struct lazymeta
+{
+  using type = lazymeta;
+  using value_type = std::remove_cv_t<
+                     std::remove_reference_t<decltype(gen())>>;
+
+  mutable value_type value{};
+
+  constexpr lazymeta() noexcept = default;
+  constexpr lazymeta(value_type v) noexcept
+    : value(v), state{impl::lazy_ready} {}
+
+  // A copy is of the computed value, if ready, else uncomputed
+  lazymeta(lazymeta const& l) noexcept : lazymeta()
+  {
+    if (l.ready()) {
+      value = l.value;
+      state.store(impl::lazy_ready, std::memory_order_relaxed);
+    }
+  }
+  lazymeta& operator=(lazymeta const&) = delete;
+
+  value_type operator()() const noexcept(noexcept(gen()))
+  {
+    if (! ready())
+      init();
+    return value;
+  }
+  operator value_type() const noexcept(noexcept(gen()))
+  {
+    return operator()();
+  }
+
+  bool ready() const noexcept
+  {
+    return state.load(std::memory_order_acquire) == impl::lazy_ready;
+  }
+
+  // set(v) : the value v, as if gen() were computed, if not yet begun
+  bool set(value_type v) noexcept
+  {
+    unsigned char s = impl::lazy_idle;
+    if (! state.compare_exchange_strong(s, impl::lazy_busy,
+                                        std::memory_order_acquire))
+      return false;
+    impl::lazy_unwind unwind{state, impl::lazy_ready};
+    value = v;
+    return true;
+  }
+
+ private:
+  mutable std::atomic<unsigned char> state{impl::lazy_idle};
+
+  void init() const noexcept(noexcept(gen()))
+  {
+    for (unsigned char s = state.load(std::memory_order_acquire);
+         s != impl::lazy_ready;
+         s = state.load(std::memory_order_acquire))
+    {
+      if (s == impl::lazy_idle
+       && state.compare_exchange_strong(s, impl::lazy_busy,
+                                        std::memory_order_acquire)) {
+        impl::lazy_unwind unwind{state};
+        value = gen();
+        unwind.to = impl::lazy_ready;
+        return;
+      }
+      impl::lazy_wait(state);
+    }
+  }
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,331 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_MDRAY_HPP
+#define LML_MDRAY_HPP
+
+/*
+  mdray.hpp
+  =========
+  A multidimensional generic array type, like ray, but with an extents
+  type whose dimensions are each a metavalue, in place of std::mdspan
+  and std::extents with its single index_type and dynamic_extent value:
+
+  * extents<E...> : a metavalue extent per dimension, e.g.
+                    staticmeta<8>    metaconst extent, constant-folded
+                    staticmeta<(g)>  metastatic extent, a static global
+                    dynameta<int>    dynamic extent, per-object
+
+    Only dynamic extents take storage; the metastatic extents are empty
+    bases. Construct from the dynamic extents in order, e.g.
+
+      extents<staticmeta<8>,dynameta<int>,dynameta<int>> x{4,2};
+
+  * mdray<Storage,Extents,Layout> : aggregate of Storage storage and
+                                    Extents extents members, with the
+                                    index mapping from Layout
+
+    Storage is as for ray, e.g. T[N], T*, unique_ptr<T[]>, or a static
+            id staticmeta<(buf)>
+    Layout is a typemeta<L,m...> with layout policy L and its metadata:
+
+      typemeta<layout_right>         row-major, last index fastest
+      typemeta<layout_left>          column-major, first index fastest
+      typemeta<layout_blocked,b...>  row-major b... tiles, of row-major
+                                     blocks, one block size per rank
+
+  Element access is by m(i...), or m[i...] with C++23 multidimensional
+  subscript. Offsets are computed by Horner's rule over the extents, so
+  multiplies by constant extents and divides by constant block sizes
+  fold away, leaving only arithmetic on the dynamic extents.
+
+  Requires C++20 concepts.
+*/
+
+#include "ray.hpp"
+
+#include <tuple> // forward_as_tuple, for dynamic extent construction
+
+#pragma push_macro("NUA")
+#undef NUA
+#ifndef _MSC_VER
+# define NUA [[no_unique_address]]
+#else
+# define NUA [[msvc::no_unique_address]]
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// dynamic_index<E...>(r) : the number of dynamic extents before rank r
+template <typename...E>
+constexpr std::size_t dynamic_index(std::size_t r) noexcept
+{
+  bool const dyn[]{!metastatic<E>..., false};
+  std::size_t n = 0;
+  for (std::size_t i = 0; i != r; ++i)
+    n += dyn[i];
+  return n;
+}
+
+// extent_leaf<r,E,d> : holds the rank r extent, if dynamic, as the
+//                      d'th dynamic extent; empty for metastatic E
+template <std::size_t r, typename E, std::size_t d,
+          bool = metastatic<E>>
+struct extent_leaf
+{
+  E extent;
+
+  constexpr extent_leaf() = default;
+  template <typename...D>
+  constexpr explicit extent_leaf(std::tuple<D...> dyn) noexcept
+    : extent{static_cast<typename E::value_type>(std::get<d>(dyn))} {}
+
+  constexpr E get() const noexcept { return extent; }
+};
+
+template <std::size_t r, typename E, std::size_t d>
+struct extent_leaf<r,E,d,true>
+{
+  constexpr extent_leaf() = default;
+  template <typename...D>
+  constexpr explicit extent_leaf(std::tuple<D...>) noexcept {}
+
+  static constexpr E get() noexcept { return E{}; }
+};
+
+template <typename, typename...> struct extents_base;
+
+template <std::size_t...r, typename...E>
+struct extents_base<std::index_sequence<r...>, E...>
+  : extent_leaf<r, E, dynamic_index<E...>(r)>...
+{
+  constexpr extents_base() = default;
+  template <typename...D>
+  constexpr explicit extents_base(std::tuple<D...> dyn) noexcept
+    : extent_leaf<r, E, dynamic_index<E...>(r)>(dyn)... {}
+};
+
+} // impl
+
+template <metavalue...E>
+  requires (std::is_integral_v<
+                 std::remove_cvref_t<typename E::value_type>> && ...)
+struct extents : impl::extents_base<std::index_sequence_for<E...>,E...>
+{
+  using index_type = std::size_t;
+
+  static constexpr std::size_t rank() noexcept
+                                          { return sizeof...(E); }
+  static constexpr std::size_t rank_dynamic() noexcept
+                     { return impl::dynamic_index<E...>(rank()); }
+
+  constexpr extents() = default;
+
+  template <typename...D>
+    requires (sizeof...(D) == rank_dynamic() && sizeof...(D) != 0)
+  constexpr extents(D...dyn) noexcept
+    : impl::extents_base<std::index_sequence_for<E...>,E...>(
+                                      std::forward_as_tuple(dyn...)) {}
+
+  // get<r>() : the rank r metavalue extent
+  template <std::size_t r>
+  constexpr auto get() const noexcept
+  {
+    using E_r = impl::meta_at<r, E...>;
+    using leaf = impl::extent_leaf<r, E_r,
+                                   impl::dynamic_index<E...>(r)>;
+    if constexpr (metastatic<E_r>)
+      return leaf::get();
+    else
+      return static_cast<leaf const&>(*this).get();
+  }
+
+  // extent<r>() : the rank r extent value, read from the type if static
+  template <std::size_t r>
+  constexpr index_type extent() const noexcept
+  {
+    using E_r = impl::meta_at<r, E...>;
+    if constexpr (metastatic<E_r>)
+      return static_cast<index_type>(E_r::value);
+    else
+      return static_cast<index_type>(get<r>()());
+  }
+
+  // size() : the product of the extents
+  constexpr index_type size() const noexcept
+  {
+    return [this]<std::size_t...R>(std::index_sequence<R...>) {
+      return (index_type{1} * ... * extent<R>());
+    }(std::index_sequence_for<E...>{});
+  }
+};
+
+/* Layout policies  ************************************************ */
+/*
+  A layout policy L has a member class template L::mapping<X, m...> for
+  extents X and metadata m..., from typemeta<L,m...>, with static member
+  functions offset(x, i...) and required_span_size(x).
+*/
+
+// layout_right : row-major, C order, the last index varies fastest
+struct layout_right
+{
+  template <typename X, decltype(auto)...m> struct mapping
+  {
+    static_assert(sizeof...(m) == 0, "layout_right takes no metadata");
+
+    template <typename...I>
+    static constexpr std::size_t offset(X const& x, I...i) noexcept
+    {
+      return [&]<std::size_t...R>(std::index_sequence<R...>) {
+        std::size_t o = 0;
+        ((o = o * x.template extent<R>() + std::size_t(i)), ...);
+        return o;
+      }(std::index_sequence_for<I...>{});
+    }
+    static constexpr std::size_t required_span_size(X const& x) noexcept
+                                                   { return x.size(); }
+  };
+};
+
+// layout_left : column-major, Fortran order, the first index fastest
+struct layout_left
+{
+  template <typename X, decltype(auto)...m> struct mapping
+  {
+    static_assert(sizeof...(m) == 0, "layout_left takes no metadata");
+
+    template <typename...I>
+    static constexpr std::size_t offset(X const& x, I...i) noexcept
+    {
+      return [&]<std::size_t...R>(std::index_sequence<R...>) {
+        constexpr std::size_t n = sizeof...(I) - 1;
+        std::size_t const idx[]{std::size_t(i)...};
+        std::size_t o = 0;
+        ((o = o * x.template extent<n - R>() + idx[n - R]), ...);
+        return o;
+      }(std::index_sequence_for<I...>{});
+    }
+    static constexpr std::size_t required_span_size(X const& x) noexcept
+                                                   { return x.size(); }
+  };
+};
+
+// layout_blocked : tiled, with b... the block extent for each rank;
+//                  blocks are row-major, as are elements in a block.
+//                  Extents are padded up to a whole number of blocks.
+struct layout_blocked
+{
+  template <typename X, decltype(auto)...b> struct mapping
+  {
+    static_assert(sizeof...(b) == X::rank(),
+                  "layout_blocked needs a block extent for each rank");
+    static_assert(((b > 0) && ...), "block extents must be positive");
+
+    static constexpr std::size_t block[]{std::size_t(b)...};
+    static constexpr std::size_t block_size
+                                     = (std::size_t{1} * ... * b);
+
+    template <std::size_t r>
+    static constexpr std::size_t blocks(X const& x) noexcept
+    {
+      return (x.template extent<r>() + block[r] - 1) / block[r];
+    }
+
+    template <typename...I>
+    static constexpr std::size_t offset(X const& x, I...i) noexcept
+    {
+      return [&]<std::size_t...R>(std::index_sequence<R...>) {
+        std::size_t ob = 0, oi = 0;
+        ((ob = ob * blocks<R>(x) + std::size_t(i) / block[R],
+          oi = oi * block[R] + std::size_t(i) % block[R]), ...);
+        return ob * block_size + oi;
+      }(std::index_sequence_for<I...>{});
+    }
+    static constexpr std::size_t required_span_size(X const& x) noexcept
+    {
+      return [&]<std::size_t...R>(std::index_sequence<R...>) {
+        return (block_size * ... * blocks<R>(x));
+      }(std::make_index_sequence<X::rank()>{});
+    }
+  };
+};
+
+namespace impl {
+
+// layout_mapping<typemeta<L,m...>,X> : L::mapping<X,m...>
+template <typename Layout, typename X> struct layout_mapping;
+
+template <typename L, decltype(auto)...m, typename X>
+struct layout_mapping<typemeta<L,m...>, X>
+{
+  using type = typename L::template mapping<X, m...>;
+};
+
+} // impl
+
+/* mdray  ********************************************************** */
+
+template <typename Storage, typename Extents,
+          metatype Layout = typemeta<layout_right>>
+  requires requires (Storage a) {a[0];}
+struct mdray
+{
+  NUA Storage storage;
+  NUA Extents extents{};
+
+  using extents_type = Extents;
+  using mapping_type
+                 = typename impl::layout_mapping<Layout,Extents>::type;
+  using size_type = std::size_t;
+  using pointer = decltype(impl::ray_data(std::declval<Storage&>()));
+  using element_type = std::remove_pointer_t<pointer>;
+  using value_type = std::remove_cv_t<element_type>;
+
+  static constexpr size_type rank() noexcept { return Extents::rank(); }
+
+  template <std::size_t r>
+  constexpr size_type extent() const noexcept
+                               { return extents.template extent<r>(); }
+
+  constexpr size_type size() const noexcept { return extents.size(); }
+  constexpr bool empty() const noexcept { return size() == 0; }
+
+  constexpr size_type required_span_size() const noexcept
+                   { return mapping_type::required_span_size(extents); }
+
+  static constexpr auto data() noexcept requires metastatic<Storage>
+                            { return impl::ray_data(Storage::value); }
+  constexpr auto data() noexcept requires (!metastatic<Storage>)
+                            { return impl::ray_data(storage); }
+  constexpr auto data() const noexcept requires (!metastatic<Storage>)
+                            { return impl::ray_data(storage); }
+
+  template <typename...I> requires (sizeof...(I) == rank())
+  constexpr decltype(auto) operator()(I...i) noexcept
+            { return data()[mapping_type::offset(extents, i...)]; }
+  template <typename...I> requires (sizeof...(I) == rank())
+  constexpr decltype(auto) operator()(I...i) const noexcept
+            { return data()[mapping_type::offset(extents, i...)]; }
+
+#if __cpp_multidimensional_subscript
+  template <typename...I> requires (sizeof...(I) == rank())
+  constexpr decltype(auto) operator[](I...i) noexcept
+            { return data()[mapping_type::offset(extents, i...)]; }
+  template <typename...I> requires (sizeof...(I) == rank())
+  constexpr decltype(auto) operator[](I...i) const noexcept
+            { return data()[mapping_type::offset(extents, i...)]; }
+#endif
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#undef NUA
+#pragma pop_macro("NUA")
+
+#endif
@@ -15,6 +15,13 @@
     metaget<I>() -> staticmeta<xI>
     metaget<I...>() -> staticmeta<xI...>
                     where xI is the Ith x... argument
+
+  * meta(f) -> f.template operator()<x...>()
+               for out-of-class generic access to the x... pack
+
+  Indexing is flat, not recursive; by C++26 pack indexing x...[i] if
+  available, else by impl::meta_at<i,...> overload-set type selection,
+  so metaget<I>() has constant instantiation depth for any I.
 */
 
 static CONSTEVAL decltype(auto) metasize() noexcept
@@ -38,11 +45,18 @@ static CONSTEVAL decltype(auto) metaget() noexcept
 
     static_assert( i >= 0 && i < size, "metaget index out of bounds");
 
-    if constexpr (i == 0)
-      return staticmeta<staticmeta<x...>{}()>{};
-    else
-      return staticmeta<x...>::template metaget<i - 1>();
+#if __cpp_pack_indexing
+    return staticmeta<x...[i]>{};
+#else
+    return impl::meta_at<i, staticmeta<x>...>{};
+#endif
   }
 }
 
+template <typename F>
+static constexpr decltype(auto) meta(F&& f)
+{
+  return static_cast<F&&>(f).template operator()<x...>();
+}
+
 #endif
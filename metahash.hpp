@@ -0,0 +1,347 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_METAHASH_HPP
+#define LML_METAHASH_HPP
+
+/*
+  metahash.hpp
+  ============
+  Compile-time hashes and dense ids of meta types, for caches keyed on
+  a parameter configuration, e.g. a kernel by its full staticmeta and
+  typemeta signature, in place of string keys built from typeid names:
+
+  * meta_hash_v<M> : a constexpr 64-bit hash of meta type M, its value
+                     or type, and its metadata x..., read by M::meta(f)
+  * meta_hash(m)   -> meta_hash_v<decltype(m)>, for an object m
+
+    M is a staticmeta, dynameta or typemeta. The hash is FNV-1a over a
+    fixed encoding, so is the same for every TU, build and platform,
+    for values and types built of the fundamental types, by their
+    Itanium ABI codes, of cv, reference, pointer and array types, of
+    meta types, recursively, and of class types of a static constexpr
+    string_view member meta_name:
+
+      static_assert( meta_hash_v<staticmeta<8>> == 0xd4570537a0172f71 );
+
+    Other class types are hashed by their compiler type name, and
+    class values by their bytes, if constant, else by their compiler
+    text, as are static ids, by the name of the entity; these hashes
+    are the same for all TUs and builds by one compiler. Equality of
+    meta types is std::is_same; of their hashes, an integer compare.
+
+  * meta_ids<M...> : dense ids 0 to N-1 for a known set of meta types
+
+      using kernels = meta_ids<staticmeta<8, typemeta<float>{}>,
+                               staticmeta<16, typemeta<float>{}>,
+                               staticmeta<8, typemeta<double>{}>>;
+
+      constexpr std::size_t k = kernels::id<K>;   // at compile time
+      cache[k] ...                               // no RTTI, no string
+      std::size_t j = kernels::index(hash);       // from a runtime hash
+
+    index(h) finds the id of hash h by the metatable perfect hash or
+    sorted lookup, else returns size(); the hashes must be distinct.
+
+  Requires C++20 concepts, and the in-class metadata API, meta(f).
+*/
+
+#include "metatable.hpp"
+
+#include <array>
+#include <bit>         // bit_cast
+#include <cstdint>     // uint64_t
+#include <string_view>
+
+#if ! __cpp_concepts
+# error "metahash.hpp requires C++20 concepts"
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// fnv1a_state : the 64-bit FNV-1a hash of a byte encoding
+struct fnv1a_state
+{
+  std::uint64_t h = 0xcbf29ce484222325;
+
+  constexpr void byte(unsigned char b) noexcept
+  {
+    h = (h ^ b) * 0x100000001b3;
+  }
+  // word(u) : u as 8 bytes, little endian, for any host
+  constexpr void word(std::uint64_t u) noexcept
+  {
+    for (int i = 0; i != 64; i += 8)
+      byte(static_cast<unsigned char>(u >> i));
+  }
+  constexpr void text(std::string_view s) noexcept
+  {
+    word(s.size());
+    for (char c : s)
+      byte(static_cast<unsigned char>(c));
+  }
+};
+
+// name_text(f) : the template argument text of a __PRETTY_FUNCTION__
+constexpr std::string_view name_text(std::string_view f) noexcept
+{
+#if defined (_MSC_VER) && ! defined (__clang__)
+  auto const b = f.find("_text<") + 6;
+  auto const e = f.rfind(">(void)");
+#else
+  auto const b = f.find("= ") + 2;
+  auto e = f.find(';', b);
+  if (e == f.npos)
+    e = f.rfind(']');
+#endif
+  return f.substr(b, e - b);
+}
+
+template <typename T>
+constexpr std::string_view type_text() noexcept
+{
+#if defined (_MSC_VER) && ! defined (__clang__)
+  return name_text(__FUNCSIG__);
+#else
+  return name_text(__PRETTY_FUNCTION__);
+#endif
+}
+
+template <decltype(auto) v>
+constexpr std::string_view value_text() noexcept
+{
+#if defined (_MSC_VER) && ! defined (__clang__)
+  return name_text(__FUNCSIG__);
+#else
+  return name_text(__PRETTY_FUNCTION__);
+#endif
+}
+
+// fundamental_code<T>() : the Itanium ABI code of fundamental T, or 0
+template <typename T>
+constexpr char fundamental_code() noexcept
+{
+  using std::is_same_v;
+  if constexpr (is_same_v<T, void>)                   return 'v';
+  else if constexpr (is_same_v<T, std::nullptr_t>)    return 'n';
+  else if constexpr (is_same_v<T, bool>)              return 'b';
+  else if constexpr (is_same_v<T, char>)              return 'c';
+  else if constexpr (is_same_v<T, signed char>)       return 'a';
+  else if constexpr (is_same_v<T, unsigned char>)     return 'h';
+  else if constexpr (is_same_v<T, wchar_t>)           return 'w';
+  else if constexpr (is_same_v<T, char8_t>)           return 'u';
+  else if constexpr (is_same_v<T, char16_t>)          return 'q';
+  else if constexpr (is_same_v<T, char32_t>)          return 'r';
+  else if constexpr (is_same_v<T, short>)             return 's';
+  else if constexpr (is_same_v<T, unsigned short>)    return 't';
+  else if constexpr (is_same_v<T, int>)               return 'i';
+  else if constexpr (is_same_v<T, unsigned>)          return 'j';
+  else if constexpr (is_same_v<T, long>)              return 'l';
+  else if constexpr (is_same_v<T, unsigned long>)     return 'm';
+  else if constexpr (is_same_v<T, long long>)         return 'x';
+  else if constexpr (is_same_v<T, unsigned long long>) return 'y';
+  else if constexpr (is_same_v<T, float>)             return 'f';
+  else if constexpr (is_same_v<T, double>)            return 'd';
+  else if constexpr (is_same_v<T, long double>)       return 'e';
+  else                                                return 0;
+}
+
+// meta_head<M> : the encoding of the kind and value or type of M
+template <typename M> struct meta_head;
+
+template <typename M>
+concept meta_class = requires { &meta_head<M>::hash; };
+
+template <typename T> constexpr void hash_type(fnv1a_state&) noexcept;
+template <decltype(auto) v>
+constexpr void hash_value(fnv1a_state&) noexcept;
+
+// hash_meta<M>(h) : the head of M, then its metadata x..., by meta(f)
+template <typename M>
+constexpr void hash_meta(fnv1a_state& h) noexcept
+{
+  meta_head<M>::hash(h);
+  M::meta([&h]<decltype(auto)...x>() {
+    h.word(sizeof...(x));
+    (hash_value<x>(h), ...);
+  });
+}
+
+template <decltype(auto) v, decltype(auto)...x>
+struct meta_head<staticmeta<v,x...>>
+{
+  static constexpr void hash(fnv1a_state& h) noexcept
+  {
+    h.byte('S');
+    hash_value<v>(h);
+  }
+};
+template <typename T, decltype(auto)...x>
+struct meta_head<dynameta<T,x...>>
+{
+  static constexpr void hash(fnv1a_state& h) noexcept
+  {
+    h.byte('D');
+    hash_type<T>(h);
+  }
+};
+template <typename T, decltype(auto)...x>
+struct meta_head<typemeta<T,x...>>
+{
+  static constexpr void hash(fnv1a_state& h) noexcept
+  {
+    h.byte('T');
+    hash_type<T>(h);
+  }
+};
+
+template <typename T>
+constexpr void hash_type(fnv1a_state& h) noexcept
+{
+  if constexpr (std::is_const_v<T> || std::is_volatile_v<T>) {
+    if constexpr (std::is_const_v<T>)
+      h.byte('K');
+    if constexpr (std::is_volatile_v<T>)
+      h.byte('V');
+    hash_type<std::remove_cv_t<T>>(h);
+  }
+  else if constexpr (fundamental_code<T>() != 0)
+    h.byte(fundamental_code<T>());
+  else if constexpr (std::is_lvalue_reference_v<T>) {
+    h.byte('R');
+    hash_type<std::remove_reference_t<T>>(h);
+  }
+  else if constexpr (std::is_rvalue_reference_v<T>) {
+    h.byte('O');
+    hash_type<std::remove_reference_t<T>>(h);
+  }
+  else if constexpr (std::is_pointer_v<T>) {
+    h.byte('P');
+    hash_type<std::remove_pointer_t<T>>(h);
+  }
+  else if constexpr (std::is_array_v<T>) {
+    h.byte('A');
+    h.word(std::extent_v<T>);
+    hash_type<std::remove_extent_t<T>>(h);
+  }
+  else if constexpr (meta_class<T>)
+    hash_meta<T>(h);
+  else if constexpr (requires { std::string_view{T::meta_name}; }) {
+    h.byte('N');
+    h.text(T::meta_name);
+  }
+  else {
+    h.byte('X');
+    h.text(type_text<T>());
+  }
+}
+
+// bytes_of<T,v> : the bytes of class value v, if constant evaluable
+template <typename T, auto v>
+concept constant_bytes = requires {
+  typename std::integral_constant<int, (std::bit_cast<
+                    std::array<unsigned char, sizeof(T)>>(v), 0)>;
+};
+
+template <decltype(auto) v>
+constexpr void hash_value(fnv1a_state& h) noexcept
+{
+  using V = decltype(v);
+  if constexpr (std::is_reference_v<V>) {            // a static id
+    h.byte('I');
+    hash_type<std::remove_reference_t<V>>(h);
+    h.text(value_text<v>());
+  }
+  else {                          // a value; class values are const
+    using C = std::remove_cv_t<V>;
+    h.byte('L');
+    hash_type<C>(h);
+    if constexpr (hashable_key<C>)
+      h.word(key_bits(v));
+    else if constexpr (std::is_floating_point_v<C>
+                    && (sizeof(C) == 4 || sizeof(C) == 8))
+      h.word(std::bit_cast<std::conditional_t<sizeof(C) == 4,
+                              std::uint32_t, std::uint64_t>>(v));
+    else if constexpr (std::is_null_pointer_v<C> || std::is_empty_v<C>)
+      ;                                              // by type alone
+    else if constexpr (std::is_class_v<C>
+                    && std::has_unique_object_representations_v<C>
+                    && constant_bytes<C, v>) {
+      auto const b = std::bit_cast<std::array<unsigned char,
+                                              sizeof(C)>>(v);
+      h.word(sizeof(C));
+      for (unsigned char c : b)
+        h.byte(c);
+    }
+    else
+      h.text(value_text<v>());
+  }
+}
+
+template <typename M>
+constexpr std::uint64_t meta_hash() noexcept
+{
+  fnv1a_state h;
+  hash_meta<M>(h);
+  return h.h;
+}
+
+} // impl
+
+// meta_hash_v<M> : the constexpr hash of meta type M
+template <typename M>
+  requires impl::meta_class<M>
+inline constexpr std::uint64_t meta_hash_v = impl::meta_hash<M>();
+
+// meta_hash(m) : the constexpr hash of the meta type of m
+template <typename M>
+  requires impl::meta_class<M>
+constexpr std::uint64_t meta_hash(M const&) noexcept
+{
+  return meta_hash_v<M>;
+}
+
+// meta_ids<M...> : dense ids, in order, for the meta types M...
+template <typename...M>
+  requires (impl::meta_class<M> && ...)
+struct meta_ids
+{
+ private:
+  using hashes_t = metatable<staticmeta<meta_hash_v<M>...>>;
+
+  template <typename Q>
+  static constexpr std::size_t find() noexcept
+  {
+    constexpr bool same[]{std::is_same_v<Q,M>..., false};
+    std::size_t i = 0;
+    while (i != sizeof...(M) && ! same[i])
+      ++i;
+    return i;
+  }
+ public:
+  static constexpr std::size_t size() noexcept { return sizeof...(M); }
+
+  // id<Q> : the id of Q, its index in M...
+  template <typename Q>
+    requires (std::is_same_v<Q,M> || ...)
+  static constexpr std::size_t id = find<Q>();
+
+  // hashes() : meta_hash_v<M>..., in id order
+  static constexpr auto const& hashes() noexcept
+                                         { return hashes_t::keys(); }
+
+  // index(h) : the id of the type of hash h, else size()
+  static constexpr std::size_t index(std::uint64_t h) noexcept
+  {
+    return hashes_t::index(h);
+  }
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_METASTRUCT_HPP
+#define LML_METASTRUCT_HPP
+
+/*
+  metastruct.hpp
+  ==============
+  A heterogeneous pack of metavalue parameters, in place of n separate
+  metavalue template parameters and [[no_unique_address]] members:
+
+  * metastruct<P...> : each P a metavalue, e.g.
+                       staticmeta<8>    metaconst, folded into code
+                       staticmeta<(g)>  metastatic, a static global
+                       dynameta<int>    dynamic, a stored member
+
+    Only the dynamic parameters take storage, packed in order of
+    decreasing alignment, stably, so there's no padding between them;
+    the metastatic parameters are not stored at all. Construct from the
+    dynamic parameter values, in declaration order, e.g.
+
+      metastruct<dynameta<char>, staticmeta<64>, dynameta<double>,
+                 dynameta<int>> s{'a', 0.5, 4};
+      static_assert( sizeof s == 16 );       // double, int, char, pad 3
+
+  * get<I>(s)   -> the I'th parameter, a metavalue
+  * get<Tag>(s) -> the parameter with metadata typemeta<Tag>{}, e.g.
+
+      struct batch; struct scale;
+      using tuning = metastruct<dynameta<int, typemeta<batch>{}>,
+                                staticmeta<0.5, typemeta<scale>{}>>;
+      tuning t{64};
+      int b = get<batch>(t)();               // 64
+      get<batch>(t).value = 128;
+
+    A dynamic parameter is returned by reference and a metastatic one
+    by value, so get<...>(s)() is constexpr if the parameter is
+    metaconst, and there's no storage or load for it.
+
+  * s.size()      -> the number of parameters, sizeof...(P)
+  * s.dynamic()   -> the number of stored, dynamic parameters
+
+  Requires C++20 concepts, and class type template arguments for tags.
+*/
+
+#include "parameta.hpp"
+
+#include <array>
+#include <tuple> // forward_as_tuple, for construction in declared order
+
+#if ! __cpp_concepts
+# error "metastruct.hpp requires C++20 concepts"
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// packing_order<P...>() : indices of the dynamic P..., by decreasing
+//                         alignment, stable for equal alignment
+template <typename...P>
+constexpr auto packing_order() noexcept
+{
+  constexpr bool dyn[]{!metastatic<P>..., false};
+  constexpr std::size_t align[]{alignof(P)..., 1};
+  std::array<std::size_t, (std::size_t{0} + ... + !metastatic<P>)>
+                                                               order{};
+  std::size_t n = 0;
+  for (std::size_t i = 0; i != sizeof...(P); ++i) {
+    if (! dyn[i])
+      continue;
+    std::size_t j = n++;
+    for (; j != 0 && align[order[j-1]] < align[i]; --j)
+      order[j] = order[j-1];
+    order[j] = i;
+  }
+  return order;
+}
+
+// dynamic_rank<P...>(i) : the position of P_i among the dynamic P...
+template <typename...P>
+constexpr std::size_t dynamic_rank(std::size_t i) noexcept
+{
+  bool const dyn[]{!metastatic<P>..., false};
+  std::size_t r = 0;
+  for (std::size_t j = 0; j != i; ++j)
+    r += dyn[j];
+  return r;
+}
+
+// param_leaf<i,P> : holds the stored, dynamic, i'th parameter P
+template <std::size_t i, typename P>
+struct param_leaf
+{
+  P param;
+};
+
+template <typename, typename...> struct packed_params;
+
+template <std::size_t...o, typename...P>
+struct packed_params<std::index_sequence<o...>, P...>
+  : param_leaf<o, meta_at<o, P...>>...
+{
+  constexpr packed_params() = default;
+  template <typename...D>
+  constexpr explicit packed_params(std::tuple<D...> dyn) noexcept
+    : param_leaf<o, meta_at<o, P...>>{
+        {static_cast<typename meta_at<o, P...>::value_type>(
+          std::get<dynamic_rank<P...>(o)>(dyn))}}... {}
+};
+
+// packing<P...>::type : packed_params in packing_order<P...>()
+template <typename, typename...P> struct packing;
+
+template <std::size_t...k, typename...P>
+struct packing<std::index_sequence<k...>, P...>
+{
+  static constexpr auto order = packing_order<P...>();
+  using type = packed_params<std::index_sequence<order[k]...>, P...>;
+};
+
+template <typename...P>
+using packed_params_for = typename packing<std::make_index_sequence<
+                           packing_order<P...>().size()>, P...>::type;
+
+// tagged<Tag,P> : P has metadata typemeta<Tag>{}
+template <typename Tag, typename P>
+struct tagged : std::false_type {};
+
+template <typename Tag, typename T, decltype(auto)...x>
+struct tagged<Tag, dynameta<T,x...>>
+  : std::bool_constant<(std::is_same_v<std::remove_cvref_t<decltype(x)>,
+                                       typemeta<Tag>> || ...)> {};
+
+template <typename Tag, decltype(auto) v, decltype(auto)...x>
+struct tagged<Tag, staticmeta<v,x...>>
+  : std::bool_constant<(std::is_same_v<std::remove_cvref_t<decltype(x)>,
+                                       typemeta<Tag>> || ...)> {};
+
+// tag_index<Tag,P...>() : the index of the unique P tagged with Tag
+template <typename Tag, typename...P>
+constexpr std::size_t tag_index() noexcept
+{
+  constexpr bool tag[]{tagged<Tag,P>::value..., false};
+  static_assert( (std::size_t{0} + ... + tagged<Tag,P>::value) == 1,
+                 "metastruct tag must name exactly one parameter");
+  std::size_t i = 0;
+  while (! tag[i])
+    ++i;
+  return i;
+}
+
+} // impl
+
+template <metavalue...P>
+struct metastruct : impl::packed_params_for<P...>
+{
+  using packed = impl::packed_params_for<P...>;
+
+  static constexpr std::size_t size() noexcept { return sizeof...(P); }
+  static constexpr std::size_t dynamic() noexcept
+                     { return (std::size_t{0} + ... + !metastatic<P>); }
+
+  constexpr metastruct() = default;
+
+  template <typename...D>
+    requires (sizeof...(D) == dynamic() && sizeof...(D) != 0)
+  constexpr metastruct(D&&...dyn) noexcept
+    : packed(std::forward_as_tuple(static_cast<D&&>(dyn)...)) {}
+};
+
+// get<I>(s) : the I'th parameter of metastruct s
+template <std::size_t I, typename...P>
+constexpr decltype(auto) get(metastruct<P...>& s) noexcept
+{
+  using P_I = impl::meta_at<I, P...>;
+  if constexpr (metastatic<P_I>)
+    return P_I{};
+  else
+    return (static_cast<impl::param_leaf<I,P_I>&>(s).param);
+}
+template <std::size_t I, typename...P>
+constexpr decltype(auto) get(metastruct<P...> const& s) noexcept
+{
+  using P_I = impl::meta_at<I, P...>;
+  if constexpr (metastatic<P_I>)
+    return P_I{};
+  else
+    return (static_cast<impl::param_leaf<I,P_I> const&>(s).param);
+}
+
+// get<Tag>(s) : the parameter of metastruct s tagged typemeta<Tag>{}
+template <typename Tag, typename...P>
+constexpr decltype(auto) get(metastruct<P...>& s) noexcept
+{
+  return get<impl::tag_index<Tag, P...>()>(s);
+}
+template <typename Tag, typename...P>
+constexpr decltype(auto) get(metastruct<P...> const& s) noexcept
+{
+  return get<impl::tag_index<Tag, P...>()>(s);
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_METATABLE_HPP
+#define LML_METATABLE_HPP
+
+/*
+  metatable.hpp
+  =============
+  Constant lookup tables from staticmeta value lists, as static
+  constexpr arrays, in read-only data, with no construction at startup:
+
+  * as_array(staticmeta<xs...>{}) -> std::array<T,N> const&
+                                     of values xs..., of common type T
+
+  * metatable<Keys>         : a constant set of the Keys values
+  * metatable<Keys,Values>  : a constant map from Keys to Values values
+
+    Keys, Values are staticmeta<xs...> lists, e.g. from metaget<I...>()
+    or M::meta(f), of constexpr values (not static ids). Keys must be
+    distinct, and as many as Values.
+
+      using latency = metatable<staticmeta<op_add, op_mul, op_div>,
+                                staticmeta<1,      3,      24>>;
+
+      int const* l = latency::find(op);  // nullptr if op isn't a key
+
+    Static member functions:
+
+    * keys(), values()  -> the as_array arrays, values() for a map only
+    * size()            -> the number of keys
+    * index(k)          -> the index of key k in keys(), else size()
+    * contains(k)       -> true if k is a key
+    * find(k)           -> pointer to the value of k, else nullptr;
+                           for a set, the pointer is to the key
+
+  The lookup is chosen at compile time from the keys, as 'lookup':
+
+    metatable_lookup::direct  integral or enum keys that span a small
+                              range; a slot table indexed by k - min
+    metatable_lookup::hashed  integral or enum keys otherwise; a perfect
+                              multiplicative hash (k * m) >> (64 - bits)
+                              found by compile-time search, to one slot
+                              per key, so one multiply, load and compare
+    metatable_lookup::sorted  other key types, e.g. floating point, or
+                              if no perfect hash is found; binary search
+                              of a sorted copy of the keys
+
+  The slot and sorted index tables are static constexpr arrays too.
+*/
+
+#include "parameta.hpp"
+
+#include <array>
+#include <cstdint> // uint8_t ... uint64_t, slot and hash types
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+enum class metatable_lookup { direct, hashed, sorted };
+
+namespace impl {
+
+// meta_array<xs...>::value : std::array of the values xs..., in .rodata
+template <decltype(auto)...xs>
+struct meta_array
+{
+  static_assert( sizeof...(xs) != 0, "metatable of no values");
+  static_assert( (! std::is_reference_v<decltype(xs)> && ...),
+                 "metatable entries must be constexpr values, not ids");
+
+  using value_type = std::common_type_t<decltype(xs)...>;
+
+  static constexpr std::array<value_type, sizeof...(xs)>
+                                        value{{value_type(xs)...}};
+};
+
+// key_int(k) : integral key, or the underlying value of an enum key
+template <typename K>
+constexpr auto key_int(K const& k) noexcept
+{
+  if constexpr (std::is_enum_v<K>)
+    return static_cast<std::underlying_type_t<K>>(k);
+  else
+    return k;
+}
+
+// key_bits(k) : key as 64 bits, modulo 2^64; differences are exact
+template <typename K>
+constexpr std::uint64_t key_bits(K const& k) noexcept
+{
+  return static_cast<std::uint64_t>(key_int(k));
+}
+
+template <typename K> inline constexpr bool hashable_key
+                        = std::is_integral_v<K> || std::is_enum_v<K>;
+
+// slot_type<N> : the least unsigned type for index N, the empty slot
+template <std::size_t N> using slot_type =
+  std::conditional_t<N < 0x100,   std::uint8_t,
+  std::conditional_t<N < 0x10000, std::uint16_t, std::uint32_t>>;
+
+constexpr int ceil_log2(std::size_t n) noexcept
+{
+  int b = 0;
+  while ((std::size_t{1} << b) < n)
+    ++b;
+  return b;
+}
+
+// hash(u, m, bits) : the top bits of u * m, multiplicative hashing
+constexpr std::size_t hash(std::uint64_t u, std::uint64_t m, int bits)
+                                                            noexcept
+{
+  return std::size_t((u * m) >> (64 - bits));
+}
+
+// hash_tries : odd multipliers tried per table size; hash_grow : the
+//              number of doublings of the table size, beyond N, tried
+inline constexpr int hash_tries = 64;
+inline constexpr int hash_grow = 3;
+
+struct table_plan
+{
+  metatable_lookup lookup;
+  std::uint64_t base;   // direct offset, the least key
+  std::uint64_t mult;   // hashed multiplier
+  int bits;             // hashed table size, log 2
+  std::size_t slots;    // slot table size; direct span or 2^bits
+};
+
+// less(a, b) : key order, by key_int for integral and enum keys
+template <typename K>
+constexpr bool less(K const& a, K const& b) noexcept
+{
+  return key_int(a) < key_int(b);
+}
+
+// sorted_order(keys) : indices of keys in sorted order; insertion sort
+template <typename K, std::size_t N>
+constexpr std::array<slot_type<N>,N>
+sorted_order(std::array<K,N> const& keys) noexcept
+{
+  std::array<slot_type<N>,N> p{};
+  for (std::size_t i = 0; i != N; ++i) {
+    std::size_t j = i;
+    for (; j != 0 && less(keys[i], keys[p[j-1]]); --j)
+      p[j] = p[j-1];
+    p[j] = slot_type<N>(i);
+  }
+  return p;
+}
+
+template <typename K, std::size_t N>
+constexpr bool distinct(std::array<K,N> const& keys) noexcept
+{
+  auto const p = sorted_order(keys);
+  for (std::size_t i = 1; i < N; ++i)
+    if (! less(keys[p[i-1]], keys[p[i]]))
+      return false;
+  return true;
+}
+
+// perfect(keys, m, bits) : the hash maps the keys to distinct slots
+template <typename K, std::size_t N>
+constexpr bool perfect(std::array<K,N> const& keys, std::uint64_t m,
+                       int bits) noexcept
+{
+  std::array<bool, (std::size_t{1} << (ceil_log2(N) + hash_grow))>
+                                                               used{};
+  for (std::size_t i = 0; i != N; ++i) {
+    std::size_t const h = hash(key_bits(keys[i]), m, bits);
+    if (used[h])
+      return false;
+    used[h] = true;
+  }
+  return true;
+}
+
+// make_plan(keys) : direct, else the first perfect hash, else sorted;
+//                   with no hashing, direct else sorted
+template <typename K, std::size_t N>
+constexpr table_plan make_plan(std::array<K,N> const& keys,
+                               bool hashing = true) noexcept
+{
+  if constexpr (hashable_key<K>) {
+    auto const p = sorted_order(keys);
+    std::uint64_t const lo = key_bits(keys[p[0]]);
+    std::uint64_t const span = key_bits(keys[p[N-1]]) - lo;
+    if (span < 2 * N + 8)
+      return {metatable_lookup::direct, lo, 0, 0,
+              std::size_t(span) + 1};
+
+    int const b0 = ceil_log2(N) < 1 ? 1 : ceil_log2(N);
+    for (int b = b0; hashing && b <= ceil_log2(N) + hash_grow; ++b) {
+      std::uint64_t m = 0x9E3779B97F4A7C15u;
+      for (int t = 0; t != hash_tries; ++t) {
+        if (perfect(keys, m, b))
+          return {metatable_lookup::hashed, 0, m, b,
+                  std::size_t{1} << b};
+        m = (m * 6364136223846793005u + 1442695040888963407u) | 1u;
+      }
+    }
+  }
+  return {metatable_lookup::sorted, 0, 0, 0, 0};
+}
+
+// slot_table<Keys,plan>::value : key index by direct offset or hash,
+//                                N for an empty slot
+template <typename Keys, table_plan const& plan>
+struct slot_table
+{
+  static constexpr auto& keys = Keys::value;
+  static constexpr std::size_t N = keys.size();
+
+  static constexpr std::array<slot_type<N>, plan.slots> make() noexcept
+  {
+    std::array<slot_type<N>, plan.slots> s{};
+    for (auto& e : s)
+      e = slot_type<N>(N);
+    for (std::size_t i = 0; i != N; ++i)
+      s[plan.lookup == metatable_lookup::direct
+        ? std::size_t(key_bits(keys[i]) - plan.base)
+        : hash(key_bits(keys[i]), plan.mult, plan.bits)]
+                                                      = slot_type<N>(i);
+    return s;
+  }
+  static constexpr std::array<slot_type<N>, plan.slots> value = make();
+};
+
+// sorted_table<Keys>::order, ::keys : sorted order and sorted keys
+template <typename Keys>
+struct sorted_table
+{
+  static constexpr auto& unsorted = Keys::value;
+  static constexpr std::size_t N = unsorted.size();
+  using key_type = typename Keys::value_type;
+
+  static constexpr auto order = sorted_order(unsorted);
+
+  static constexpr std::array<key_type,N> make() noexcept
+  {
+    std::array<key_type,N> k{};
+    for (std::size_t i = 0; i != N; ++i)
+      k[i] = unsorted[order[i]];
+    return k;
+  }
+  static constexpr std::array<key_type,N> keys = make();
+};
+
+template <typename Keys>
+inline constexpr table_plan plan_of = make_plan(Keys::value);
+
+template <typename Keys>
+inline constexpr table_plan unhashed_plan_of
+                                     = make_plan(Keys::value, false);
+
+// key_table<Keys,P> : index(k) by the planned lookup, P = plan_of<Keys>
+template <typename Keys, table_plan const& P = plan_of<Keys>>
+struct key_table
+{
+  using key_type = typename Keys::value_type;
+  static constexpr std::size_t N = Keys::value.size();
+  static constexpr table_plan const& plan = P;
+
+  static_assert( distinct(Keys::value),
+                 "metatable keys must be unique");
+
+  static constexpr std::size_t index(key_type const& k) noexcept
+  {
+    auto const& keys = Keys::value;
+    if constexpr (plan.lookup == metatable_lookup::direct) {
+      auto const& slot = slot_table<Keys, P>::value;
+      std::uint64_t const d = key_bits(k) - plan.base;
+      return d < plan.slots ? std::size_t(slot[std::size_t(d)]) : N;
+    }
+    else if constexpr (plan.lookup == metatable_lookup::hashed) {
+      auto const& slot = slot_table<Keys, P>::value;
+      std::size_t const i
+                        = slot[hash(key_bits(k), plan.mult, plan.bits)];
+      return i != N && keys[i] == k ? i : N;
+    }
+    else {
+      auto const& sorted = sorted_table<Keys>::keys;
+      std::size_t lo = 0, n = N;
+      while (n != 0) {
+        std::size_t const half = n / 2;
+        if (less(sorted[lo + half], k)) {
+          lo += half + 1;
+          n -= half + 1;
+        }
+        else
+          n = half;
+      }
+      return lo != N && ! less(k, sorted[lo])
+           ? std::size_t(sorted_table<Keys>::order[lo]) : N;
+    }
+  }
+};
+
+} // impl
+
+// as_array(staticmeta<xs...>) -> std::array of xs..., static constexpr
+template <decltype(auto)...xs>
+constexpr auto const& as_array(staticmeta<xs...>) noexcept
+{
+  return impl::meta_array<xs...>::value;
+}
+
+template <typename Keys, typename Values = void> struct metatable;
+
+// metatable<staticmeta<k...>> : constant set of keys k...
+template <decltype(auto)...k>
+struct metatable<staticmeta<k...>>
+{
+ private:
+  using keys_t = impl::meta_array<k...>;
+  using table = impl::key_table<keys_t>;
+ public:
+  using key_type = typename keys_t::value_type;
+  using value_type = key_type;
+
+  static constexpr metatable_lookup lookup = table::plan.lookup;
+
+  static constexpr auto const& keys() noexcept { return keys_t::value; }
+  static constexpr std::size_t size() noexcept { return sizeof...(k); }
+
+  static constexpr std::size_t index(key_type const& key) noexcept
+                                          { return table::index(key); }
+  static constexpr bool contains(key_type const& key) noexcept
+                                       { return index(key) != size(); }
+  static constexpr key_type const* find(key_type const& key) noexcept
+  {
+    std::size_t const i = index(key);
+    return i != size() ? &keys_t::value[i] : nullptr;
+  }
+};
+
+// metatable<staticmeta<k...>,staticmeta<v...>> : constant map k -> v
+template <decltype(auto)...k, decltype(auto)...v>
+struct metatable<staticmeta<k...>, staticmeta<v...>>
+{
+  static_assert( sizeof...(k) == sizeof...(v),
+                 "metatable needs a value for each key");
+ private:
+  using keys_t = impl::meta_array<k...>;
+  using values_t = impl::meta_array<v...>;
+  using table = impl::key_table<keys_t>;
+ public:
+  using key_type = typename keys_t::value_type;
+  using value_type = typename values_t::value_type;
+
+  static constexpr metatable_lookup lookup = table::plan.lookup;
+
+  static constexpr auto const& keys() noexcept { return keys_t::value; }
+  static constexpr auto const& values() noexcept
+                                           { return values_t::value; }
+  static constexpr std::size_t size() noexcept { return sizeof...(k); }
+
+  static constexpr std::size_t index(key_type const& key) noexcept
+                                          { return table::index(key); }
+  static constexpr bool contains(key_type const& key) noexcept
+                                       { return index(key) != size(); }
+  static constexpr value_type const* find(key_type const& key) noexcept
+  {
+    std::size_t const i = index(key);
+    return i != size() ? &values_t::value[i] : nullptr;
+  }
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -1,14 +1,22 @@
 #ifndef NAMESPACE_ID /* Configure your possibly-nested namespace-id */
 # define NAMESPACE_ID lml
 #endif
-#ifndef NAMESPACE_ID_IS_EMPTY
-# define NAMESPACE_ID_IS_EMPTY_(ID,ONE)ID##ONE
-# define NAMESPACE_ID_IS_EMPTY(NS_ID)NAMESPACE_ID_IS_EMPTY_(NS_ID,0x01)
-# if ! NAMESPACE_ID_IS_EMPTY(NAMESPACE_ID)
+/* Open / close toggle, with its state in LML_NAMESPACE_OPEN, private to
+   the library, so independent of other headers' namespace toggles and
+   of user macros; each header closes what it opens, leaving no state.
+   Keep NAMESPACE_ID the same for all the library headers in a TU. */
+#ifndef LML_NAMESPACE_OPEN
+# define LML_NAMESPACE_OPEN
+# define LML_NS_IS_EMPTY_(ID,ONE)ID##ONE
+# define LML_NS_IS_EMPTY(NS_ID)LML_NS_IS_EMPTY_(NS_ID,0x01)
+# if ! LML_NS_IS_EMPTY(NAMESPACE_ID)
 namespace NAMESPACE_ID {
 # endif
-#elif ! NAMESPACE_ID_IS_EMPTY(NAMESPACE_ID)
+#else
+# if ! LML_NS_IS_EMPTY(NAMESPACE_ID)
 }
-#undef NAMESPACE_ID_IS_EMPTY
-#undef NAMESPACE_ID_IS_EMPTY_
+# endif
+# undef LML_NS_IS_EMPTY
+# undef LML_NS_IS_EMPTY_
+# undef LML_NAMESPACE_OPEN
 #endif
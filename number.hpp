@@ -0,0 +1,286 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_NUMBER_HPP
+#define LML_NUMBER_HPP
+
+/*
+  number.hpp
+  ==========
+  A binary fixed-point number format parameterized by metavalues, the
+  library's first use case; one definition serves compile-time formats
+  that fold to shifts and masks, and runtime formats for prototyping:
+
+  * number<Width,Bias,Base> : a Width-bit unsigned code, representing
+                              value = (code - Bias) * 2^Base
+
+    Width  bits in the code, 1 to 64
+    Bias   integer offset of the code; default zero_bias, 0
+    Base   binary exponent of the unit, the scale, -63 to 63; default
+           zero_base, 0
+
+    Each is a metavalue of integral value_type, held as a
+    [[no_unique_address]] member, so metastatic parameters are free and
+    dynameta parameters are per-object, e.g.
+
+      number<staticmeta<8>, staticmeta<128>, staticmeta<-4>> q{};
+      static_assert( sizeof q == 1 );         // uint8_t code only
+
+      number<dynameta<int>, dynameta<int>> p{{12},{2048}};
+
+    Members of the same empty type can't share an address, so the zero
+    defaults are distinct types, staticmeta<0> tagged, for sizeof
+    number<staticmeta<8>> == 1. Explicit metastatic parameters of the
+    same type, e.g. staticmeta<0> for both Bias and Base, take a byte.
+    A dynamic Width out of 1 to 64 gives an empty or full mask.
+
+  The code_type is the least unsigned type of the Width if metaconst,
+  else std::uint64_t. Codes wrap modulo 2^Width, masked on every write.
+
+  * n.bits(), n.offset(), n.exponent() -> Width, Bias, Base values
+  * n.unpack() -> the signed scaled integer (code - Bias)
+  * n.pack(s)  sets the code for scaled integer s; returns *this
+  * n.to<F>()  -> the value as floating point type F
+  * n.from(x)  sets the code for value x, rounded to nearest; *this;
+               saturated to int64_t (NaN to 0) before it wraps
+
+  Arithmetic +, -, * is on numbers of the same type, and format; the
+  result takes the format of the left operand. Products are rescaled by
+  an arithmetic shift of Base bits, of the exact 128-bit product.
+
+  Requires C++20 concepts.
+*/
+
+#include "parameta.hpp"
+
+#include <cmath>   // ldexp, for a dynamic Base
+#include <cstdint> // uint8_t ... uint64_t, int64_t
+
+#if ! __cpp_concepts
+# error "number.hpp requires C++20 concepts"
+#endif
+
+#pragma push_macro("NUA")
+#undef NUA
+#ifndef _MSC_VER
+# define NUA [[no_unique_address]]
+#else
+# define NUA [[msvc::no_unique_address]]
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// uint_least<w> : the least unsigned integer type of at least w bits
+template <int w> using uint_least =
+  std::conditional_t<w <= 8,  std::uint8_t,
+  std::conditional_t<w <= 16, std::uint16_t,
+  std::conditional_t<w <= 32, std::uint32_t, std::uint64_t>>>;
+
+// code_type<W> : uint_least<W::value> if W is metaconst, else uint64_t
+template <typename W> struct code_type { using type = std::uint64_t; };
+template <typename W> requires metaconst<W>
+struct code_type<W> { using type = uint_least<W::value>; };
+
+// value_of(m) : the value of metavalue m, from the type if metastatic
+//               (so not by consteval call on a non-constant object)
+template <typename M>
+constexpr auto value_of(M const& m) noexcept
+{
+  if constexpr (metastatic<M>)
+    return M::value;
+  else
+    return m();
+}
+
+// valid_width<W>() : W is 1 to 64 bits, if known at compile time
+template <typename W>
+constexpr bool valid_width() noexcept
+{
+  if constexpr (metaconst<W>)
+    return 0 < W::value && W::value <= 64;
+  else
+    return true;
+}
+
+// mask(w) : the low w bits set; clamped, 0 for w <= 0, all for w >= 64,
+//           as a dynamic Width is unchecked
+constexpr std::uint64_t mask(int w) noexcept
+{
+  return w <= 0 ? 0 : w >= 64 ? ~std::uint64_t{}
+                              : ~std::uint64_t{} >> (64 - w);
+}
+
+// valid_base<B>() : |B| < 64, if known at compile time
+template <typename B>
+constexpr bool valid_base() noexcept
+{
+  if constexpr (metaconst<B>)
+    return -64 < B::value && B::value < 64;
+  else
+    return true;
+}
+
+struct bias_tag;
+struct base_tag;
+
+// pow2<F>(e) : 2^e as F, by repeated squaring; constexpr ldexp
+template <typename F>
+constexpr F pow2(int e) noexcept
+{
+  F r = 1, b = e < 0 ? F(0.5) : F(2);
+  for (unsigned n = e < 0 ? -unsigned(e) : unsigned(e); n; n >>= 1) {
+    if (n & 1) r *= b;
+    b *= b;
+  }
+  return r;
+}
+
+// mul_shift(a, b, e) : the low 64 bits of a * b * 2^e; the product
+//                      exact in 128 bits, then shifted arithmetically,
+//                      by |e| clamped to the width, so with no UB
+constexpr std::uint64_t mul_shift(std::int64_t a, std::int64_t b, int e)
+                                                               noexcept
+{
+  auto const abs = [](std::int64_t v) {
+    return v < 0 ? 0 - std::uint64_t(v) : std::uint64_t(v);
+  };
+  std::uint64_t const x = abs(a), y = abs(b), m = 0xffffffff;
+  std::uint64_t const p00 = (x & m) * (y & m),
+                      p01 = (x & m) * (y >> 32),
+                      p10 = (x >> 32) * (y & m),
+                      p11 = (x >> 32) * (y >> 32);
+  std::uint64_t const mid = (p00 >> 32) + (p01 & m) + (p10 & m);
+  std::uint64_t lo = mid << 32 | (p00 & m);
+  std::uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+  if ((a < 0) != (b < 0)) {              // negate, two's complement
+    lo = ~lo + 1;
+    hi = ~hi + (lo == 0);
+  }
+  if (e >= 0)
+    return e < 64 ? lo << e : 0;
+  unsigned const r = 0u - unsigned(e);
+  if (r >= 64)
+    return std::uint64_t(std::int64_t(hi) >> (r < 127 ? r - 64 : 63));
+  return lo >> r | hi << (64 - r);
+}
+
+// saturate<F>(x) : x as int64_t, clamped to its range; NaN as 0
+template <typename F>
+constexpr std::int64_t saturate(F x) noexcept
+{
+  constexpr F limit = pow2<F>(63);
+  return x != x        ? 0
+       : x >= limit    ? INT64_MAX
+       : ! (x > -limit) ? INT64_MIN
+                       : std::int64_t(x);
+}
+
+} // impl
+
+// zero_bias, zero_base : the default Bias and Base, zero, of distinct
+//                        types so that both have no storage
+using zero_bias = staticmeta<0, typemeta<impl::bias_tag>{}>;
+using zero_base = staticmeta<0, typemeta<impl::base_tag>{}>;
+
+template <metavalue Width,
+          metavalue Bias = zero_bias,
+          metavalue Base = zero_base>
+  requires (std::is_integral_v<std::remove_cvref_t<
+                         typename Width::value_type>>
+         && std::is_integral_v<std::remove_cvref_t<
+                         typename Bias::value_type>>
+         && std::is_integral_v<std::remove_cvref_t<
+                         typename Base::value_type>>)
+struct number
+{
+  using code_type = typename impl::code_type<Width>::type;
+
+  NUA Width width{};
+  NUA Bias bias{};
+  NUA Base base{};
+  code_type code{};
+
+  static_assert( impl::valid_width<Width>(),
+                 "number Width must be 1 to 64 bits");
+  static_assert( impl::valid_base<Base>(),
+                 "number Base must be -63 to 63");
+
+  // bits(), offset(), exponent() : the Width, Bias and Base values
+  constexpr int bits() const noexcept
+                             { return int(impl::value_of(width)); }
+  constexpr std::int64_t offset() const noexcept
+                  { return std::int64_t(impl::value_of(bias)); }
+  constexpr int exponent() const noexcept
+                             { return int(impl::value_of(base)); }
+
+  constexpr code_type mask() const noexcept
+                             { return code_type(impl::mask(bits())); }
+
+  // unpack, pack : modulo 2^64, in unsigned arithmetic, so a wide code
+  //                or an extreme Bias doesn't overflow
+  constexpr std::int64_t unpack() const noexcept
+  {
+    return std::int64_t(std::uint64_t(code) - std::uint64_t(offset()));
+  }
+  constexpr number& pack(std::int64_t s) noexcept
+  {
+    code = code_type((std::uint64_t(s) + std::uint64_t(offset()))
+                     & mask());
+    return *this;
+  }
+
+  template <typename F = double>
+  constexpr F to() const noexcept
+  {
+    if constexpr (metaconst<Base>) {
+      constexpr F unit = impl::pow2<F>(Base::value);
+      return F(unpack()) * unit;
+    }
+    else
+      return std::ldexp(F(unpack()), exponent());
+  }
+  template <typename F>
+  constexpr number& from(F x) noexcept
+  {
+    F scaled;
+    if constexpr (metaconst<Base>) {
+      constexpr F inverse = impl::pow2<F>(-Base::value);
+      scaled = x * inverse;
+    }
+    else
+      scaled = std::ldexp(x, -exponent());
+    return pack(impl::saturate(scaled < 0 ? scaled - F(0.5)
+                                          : scaled + F(0.5)));
+  }
+
+  friend constexpr number operator+(number a, number const& b) noexcept
+  {
+    return a.pack(std::int64_t(std::uint64_t(a.unpack())
+                             + std::uint64_t(b.unpack())));
+  }
+  friend constexpr number operator-(number a, number const& b) noexcept
+  {
+    return a.pack(std::int64_t(std::uint64_t(a.unpack())
+                             - std::uint64_t(b.unpack())));
+  }
+  friend constexpr number operator*(number a, number const& b) noexcept
+  {
+    return a.pack(std::int64_t(
+             impl::mul_shift(a.unpack(), b.unpack(), a.exponent())));
+  }
+
+  friend constexpr bool operator==(number const& a, number const& b)
+                           noexcept { return a.unpack() == b.unpack(); }
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#undef NUA
+#pragma pop_macro("NUA")
+
+#endif
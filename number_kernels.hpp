@@ -0,0 +1,177 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_NUMBER_KERNELS_HPP
+#define LML_NUMBER_KERNELS_HPP
+
+/*
+  number_kernels.hpp
+  ==================
+  Batched conversions between arrays of number codes and floating point
+  values, and between number formats, for bulk quantization:
+
+  * unpack(fmt, codes, values) : values[i] = value of codes[i] in fmt
+  * pack(fmt, values, codes)   : codes[i] = code of values[i] in fmt,
+                                 rounded to nearest, wrapped to Width
+  * convert(sfmt, scodes, dfmt, dcodes) : recode from format sfmt to
+                                 dfmt, rescaled by shift of the Bases,
+                                 wrapped, or shifted out, past the
+                                 width of the intermediate integer
+
+  fmt is a number<Width,Bias,Base>, used for its format, not its code.
+  The arrays are contiguous ranges, e.g. ray, std::array, std::vector,
+  taken by std::data and std::size, with codes of any unsigned type;
+  the count is the size of the first array, if constant then constexpr.
+
+  The loops are simple, branch-free and in the vectorizer's idiom, with
+  the format hoisted, so compilers generate SSE / AVX2 / AVX-512 / NEON
+  code for the target; with metaconst formats all the parameters are
+  immediates. The intermediate integer type is 32-bit for codes of up
+  to 16 bits, so float-to-int conversions vectorize without AVX-512;
+  64-bit for wider codes, whose values may exceed INT32_MAX.
+
+  A dynameta Width is dispatched once per call, by dispatch_static, to
+  a kernel with constant mask from a candidate list of Widths, default
+  kernel_widths = staticmeta<8,16,32>, else runs with the dynamic mask:
+
+    pack<staticmeta<4,8,12>>(fmt, values, codes);
+
+  Requires C++20 concepts.
+*/
+
+#include "number.hpp"
+#include "dispatch_static.hpp"
+
+#include <iterator> // data, size
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+// kernel_widths : default candidate list for dynamic Width dispatch
+using kernel_widths = staticmeta<8,16,32>;
+
+namespace impl {
+
+// unit<F>(fmt) : 2^Base as F; constexpr if Base is metaconst
+template <typename F, typename Num>
+constexpr F unit(Num const& fmt) noexcept
+{
+  if constexpr (metaconst<decltype(fmt.base)>)
+    return pow2<F>(decltype(fmt.base)::value);
+  else
+    return std::ldexp(F(1), fmt.exponent());
+}
+
+// scaled_int<C> : signed intermediate type for code element type C,
+//                 holding every code value of C, as does number
+template <typename C> using scaled_int
+  = std::conditional_t<sizeof(C) < 4, std::int32_t, std::int64_t>;
+
+// with_width(fmt, f) : f(fmt) if Width is metaconst, else f(rfmt) for
+//  rfmt with Width promoted by dispatch_static<Widths> of fmt.width
+template <typename Widths, typename Num, typename Fn>
+constexpr void with_width(Num const& fmt, Fn f)
+{
+  if constexpr (metaconst<decltype(fmt.width)>)
+    f(fmt);
+  else
+    dispatch_static<Widths>(fmt.width, [&](auto w) {
+      f(number<decltype(w), decltype(fmt.bias), decltype(fmt.base)>
+                                           {w, fmt.bias, fmt.base, {}});
+    });
+}
+
+template <typename Num, typename F, typename C>
+constexpr void unpack_n(Num const& fmt, C const* code, F* value,
+                        std::size_t n) noexcept
+{
+  using I = scaled_int<C>;
+  F const u = unit<F>(fmt);
+  I const bias = I(fmt.offset());
+  for (std::size_t i = 0; i != n; ++i)
+    value[i] = F(I(code[i]) - bias) * u;
+}
+
+template <typename Num, typename F, typename C>
+constexpr void pack_n(Num const& fmt, F const* value, C* code,
+                      std::size_t n) noexcept
+{
+  using I = scaled_int<C>;
+  F const v = F(1) / unit<F>(fmt);
+  I const bias = I(fmt.offset());
+  C const mask = C(fmt.mask());
+  for (std::size_t i = 0; i != n; ++i) {
+    F const s = value[i] * v;
+    code[i] = C(I(s < 0 ? s - F(0.5) : s + F(0.5)) + bias) & mask;
+  }
+}
+
+template <typename Src, typename Dst, typename CS, typename CD>
+constexpr void convert_n(Src const& sfmt, CS const* scode,
+                         Dst const& dfmt, CD* dcode,
+                         std::size_t n) noexcept
+{
+  using I = scaled_int<std::conditional_t<(sizeof(CS) > sizeof(CD)),
+                                          CS, CD>>;
+  using U = std::make_unsigned_t<I>;
+  constexpr std::int64_t bits = 8 * sizeof(I);
+  U const sbias = U(sfmt.offset()), dbias = U(dfmt.offset());
+  CD const mask = CD(dfmt.mask());
+  std::int64_t const e = std::int64_t(sfmt.exponent())
+                       - dfmt.exponent();
+  // Unsigned, so wrapping, left shifts by a multiply, all out past the
+  // width of I; arithmetic right shifts, by at most its width less 1
+  if (e >= 0) {
+    U const scale = e < bits ? U(U(1) << e) : U(0);
+    for (std::size_t i = 0; i != n; ++i)
+      dcode[i] = CD((U(scode[i]) - sbias) * scale + dbias) & mask;
+  }
+  else {
+    int const r = int(-e < bits ? -e : bits - 1);
+    for (std::size_t i = 0; i != n; ++i)
+      dcode[i] = CD(U(I(U(scode[i]) - sbias) >> r) + dbias) & mask;
+  }
+}
+
+} // impl
+
+// unpack(fmt, codes, values) : values[i] = value of codes[i] in fmt
+template <typename Widths = kernel_widths,
+          typename Num, typename Codes, typename Values>
+constexpr void unpack(Num const& fmt, Codes const& codes,
+                      Values&& values)
+{
+  impl::with_width<Widths>(fmt, [&](auto const& f) {
+    impl::unpack_n(f, std::data(codes), std::data(values),
+                   std::size(codes));
+  });
+}
+
+// pack(fmt, values, codes) : codes[i] = code of values[i] in fmt
+template <typename Widths = kernel_widths,
+          typename Num, typename Values, typename Codes>
+constexpr void pack(Num const& fmt, Values const& values, Codes&& codes)
+{
+  impl::with_width<Widths>(fmt, [&](auto const& f) {
+    impl::pack_n(f, std::data(values), std::data(codes),
+                 std::size(values));
+  });
+}
+
+// convert(sfmt, scodes, dfmt, dcodes) : recode scodes as dfmt codes
+template <typename Widths = kernel_widths,
+          typename Src, typename SCodes, typename Dst, typename DCodes>
+constexpr void convert(Src const& sfmt, SCodes const& scodes,
+                       Dst const& dfmt, DCodes&& dcodes)
+{
+  impl::with_width<Widths>(dfmt, [&](auto const& d) {
+    impl::convert_n(sfmt, std::data(scodes), d, std::data(dcodes),
+                    std::size(scodes));
+  });
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
@@ -0,0 +1,379 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_PARALLEL_HPP
+#define LML_PARALLEL_HPP
+
+/*
+  parallel.hpp
+  ============
+  Parallel for_each, transform, reduce and transform_reduce over the
+  elements of a ray, or of a dense mdray, split into chunks that run
+  on a pluggable executor; the chunking is chosen by the staticity of
+  the extents and of the chunk count:
+
+  * par_policy<Chunks,Executor> : a chunk count metavalue and executor
+
+    par(k)        k chunks, by default one per hardware thread, on new
+                  threads; a dynamic chunk count
+    par_static<K> K chunks, a metaconst chunk count, on new threads
+    pol.on(e)     the policy pol, on executor e
+
+    An executor is any e(tasks, task), that calls task(k) for each k in
+    [0, tasks), concurrently or not, and returns when all are done; a
+    thread pool plugs in by this signature. thread_executor runs task 0
+    on the calling thread and the rest on new threads; inline_executor
+    runs them in order, on the calling thread.
+
+  * for_each(pol, r, f)                     f(e) for each element e
+  * transform(pol, r, out, f)               out[i] = f(r[i])
+  * reduce(pol, r, init, op = plus)         init op r[0] op r[1] ...
+  * transform_reduce(pol, r, init, op, f)   init op f(r[0]) op ...
+
+    Chunks are split at multiples of a 64-byte cache line of elements,
+    at line boundaries of the written data's address, so workers don't
+    share lines, for elements of a size dividing 64; reductions are in
+    element order, so op need only be associative. With a metaconst
+    extent and chunk count, the chunk bounds are a constexpr table,
+    shifted by one subtraction for the data's offset in its line;
+    otherwise they adapt to the runtime size.
+
+      ray<float*, dynameta<std::size_t>> v{p, {n}};
+      float sum = reduce(par(), v, 0.f);
+      for_each(par_static<8>, m, [](float& x) { x *= 2; });
+
+  An mdray is dense if its layout is layout_right or layout_left, with
+  no padding; out of transform must have the size of r.
+
+  Requires C++20 concepts.
+*/
+
+#include "mdray.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>    // uintptr_t
+#include <functional> // plus
+#include <optional>
+#include <thread>
+#include <vector>
+
+#pragma push_macro("NUA")
+#undef NUA
+#ifndef _MSC_VER
+# define NUA [[no_unique_address]]
+#else
+# define NUA [[msvc::no_unique_address]]
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+// thread_executor : task 0 on the calling thread, the rest on threads
+struct thread_executor
+{
+  template <typename F>
+  void operator()(std::size_t tasks, F& task) const
+  {
+    std::vector<std::thread> workers;
+    workers.reserve(tasks > 1 ? tasks - 1 : 0);
+    for (std::size_t k = 1; k < tasks; ++k)
+      workers.emplace_back([&task, k] { task(k); });
+    if (tasks != 0)
+      task(std::size_t{0});
+    for (auto& w : workers)
+      w.join();
+  }
+};
+
+// inline_executor : all the tasks in order, on the calling thread
+struct inline_executor
+{
+  template <typename F>
+  constexpr void operator()(std::size_t tasks, F& task) const
+  {
+    for (std::size_t k = 0; k != tasks; ++k)
+      task(k);
+  }
+};
+
+template <metavalue Chunks, typename Executor = thread_executor>
+  requires std::is_integral_v<
+                 std::remove_cvref_t<typename Chunks::value_type>>
+struct par_policy
+{
+  NUA Chunks chunks{};
+  NUA Executor executor{};
+
+  template <typename E>
+  constexpr par_policy<Chunks, E> on(E e) const noexcept
+  {
+    return {chunks, e};
+  }
+};
+
+// par(k) : a policy of k chunks, one per hardware thread by default
+inline par_policy<dynameta<unsigned>>
+par(unsigned k = std::thread::hardware_concurrency()) noexcept
+{
+  return {{k != 0 ? k : 1}};
+}
+
+// par_static<K> : a policy of K chunks, a metaconst chunk count
+template <unsigned K>
+  requires (K != 0)
+inline constexpr par_policy<staticmeta<K>> par_static{};
+
+namespace impl {
+
+inline constexpr std::size_t cache_line = 64;
+
+// line_elements<T> : elements of T per cache line, at least one
+template <typename T>
+inline constexpr std::size_t line_elements
+              = sizeof(T) < cache_line ? cache_line / sizeof(T) : 1;
+
+// chunk_step(n, k, w) : elements per chunk, of n split in k chunks,
+//                       rounded up to a multiple of w
+constexpr std::size_t chunk_step(std::size_t n, std::size_t k,
+                                 std::size_t w) noexcept
+{
+  std::size_t const per = (n + k - 1) / k;
+  return per == 0 ? w : (per + w - 1) / w * w;
+}
+
+// line_shift(p) : the elements to shift inner chunk bounds back by, so
+//                 that they fall on cache line boundaries of address p
+template <typename T>
+std::size_t line_shift(T const* p) noexcept
+{
+  constexpr std::size_t W = line_elements<T>;
+  if constexpr (sizeof(T) >= cache_line)
+    return 0;
+  else {
+    auto const a = reinterpret_cast<std::uintptr_t>(p) % cache_line;
+    std::size_t const lead = ((cache_line - a) % cache_line
+                              + sizeof(T) - 1) / sizeof(T);
+    return (W - lead % W) % W;
+  }
+}
+
+// static_chunks<N,K,W> : the constexpr chunk bounds table, of N split
+//                        in at most K chunks at multiples of W
+template <std::size_t N, std::size_t K, std::size_t W>
+struct static_chunks
+{
+  static constexpr std::size_t step = chunk_step(N, K, W);
+  static constexpr std::size_t count = (N + step - 1) / step;
+  static constexpr auto bounds = [] {
+    std::array<std::size_t, count + 1> b{};
+    for (std::size_t k = 0; k != count; ++k)
+      b[k] = k * step;
+    b[count] = N;
+    return b;
+  }();
+};
+
+inline constexpr std::size_t dynamic_size = std::size_t(-1);
+
+// static_size<R>() : the size of ray or mdray R if a constant, else
+//                    dynamic_size
+template <typename R>
+constexpr std::size_t static_size() noexcept
+{
+  if constexpr (requires {
+                 std::integral_constant<std::size_t, R::size()>{}; })
+    return R::size();
+  else if constexpr (requires { typename R::extents_type; }) {
+    using X = typename R::extents_type;
+    if constexpr (X::rank_dynamic() == 0 && requires {
+                 std::integral_constant<std::size_t, X{}.size()>{}; })
+      return X{}.size();
+    else
+      return dynamic_size;
+  }
+  else
+    return dynamic_size;
+}
+
+// dense<R> : a ray, or an mdray of a layout with no padding
+template <typename R> inline constexpr bool dense = false;
+template <typename S, typename E>
+inline constexpr bool dense<ray<S,E>> = true;
+template <typename S, typename X>
+inline constexpr bool dense<mdray<S,X,typemeta<layout_right>>> = true;
+template <typename S, typename X>
+inline constexpr bool dense<mdray<S,X,typemeta<layout_left>>> = true;
+
+// chunks_of(pol) : the chunk count of policy pol, read from the type
+//                  if metastatic
+template <typename P>
+constexpr std::size_t chunks_of(P const& pol) noexcept
+{
+  using Chunks = decltype(pol.chunks);
+  if constexpr (metastatic<Chunks>)
+    return static_cast<std::size_t>(Chunks::value);
+  else
+    return static_cast<std::size_t>(pol.chunks());
+}
+
+// par_chunks(pol, p, n, body) : body(k, b, e) for each chunk k, [b, e),
+//                  of n elements of T at p, on pol's executor; returns
+//                  the number of chunks run, at most pol's chunk count
+//
+// The inner bounds, at multiples of a line of elements, shift back by
+// less than a line, to the line boundaries of p; each is still past
+// the bound before, so the count is the same, the last chunk longer.
+template <typename T, std::size_t N, typename P, typename Body>
+std::size_t par_chunks(P const& pol, T const* p, std::size_t n,
+                       Body body)
+{
+  using Chunks = decltype(pol.chunks);
+  constexpr std::size_t W = line_elements<T>;
+  std::size_t const d = line_shift(p);
+  if constexpr (N != dynamic_size && metaconst<Chunks>) {
+    using plan = static_chunks<N, std::size_t(Chunks::value), W>;
+    auto task = [&body, d](std::size_t k) {
+      body(k, k == 0 ? 0 : plan::bounds[k] - d,
+           k + 1 == plan::count ? N : plan::bounds[k + 1] - d);
+    };
+    pol.executor(plan::count, task);
+    return plan::count;
+  }
+  else {
+    std::size_t const step = chunk_step(n, chunks_of(pol), W);
+    std::size_t const count = (n + step - 1) / step;
+    auto task = [&body, step, count, n, d](std::size_t k) {
+      body(k, k == 0 ? 0 : k * step - d,
+           k + 1 == count ? n : (k + 1) * step - d);
+    };
+    pol.executor(count, task);
+    return count;
+  }
+}
+
+// chunk_count<T,N>(pol, n) : chunks of n elements of T, a constant if
+//                            N and the chunk count are both constants
+template <typename T, std::size_t N, typename P>
+constexpr std::size_t chunk_count(P const& pol, std::size_t n) noexcept
+{
+  using Chunks = decltype(pol.chunks);
+  if constexpr (N != dynamic_size && metaconst<Chunks>)
+    return static_chunks<N, std::size_t(Chunks::value),
+                         line_elements<T>>::count;
+  else {
+    std::size_t const step = chunk_step(n, chunks_of(pol),
+                                        line_elements<T>);
+    return (n + step - 1) / step;
+  }
+}
+
+// partial<T> : a per-chunk reduction slot, a cache line apart
+template <typename T>
+struct alignas(cache_line) partial
+{
+  std::optional<T> value;
+};
+
+template <typename R>
+concept par_range = dense<std::remove_cvref_t<R>>
+                 && requires (R& r) { r.data(); r.size(); };
+
+} // impl
+
+// for_each(pol, r, f) : f(e) for each element e of r, in parallel
+template <typename P, typename R, typename F>
+  requires impl::par_range<R>
+void for_each(P const& pol, R& r, F f)
+{
+  using T = std::remove_cvref_t<decltype(*r.data())>;
+  auto const p = r.data();
+  impl::par_chunks<T, impl::static_size<std::remove_cv_t<R>>()>(
+    pol, p, r.size(),
+    [p, &f](std::size_t, std::size_t b, std::size_t e) {
+      for (std::size_t i = b; i != e; ++i)
+        f(p[i]);
+    });
+}
+
+// transform(pol, r, out, f) : out[i] = f(r[i]) for each i, in parallel
+template <typename P, typename R, typename O, typename F>
+  requires impl::par_range<R> && impl::par_range<O>
+void transform(P const& pol, R& r, O& out, F f)
+{
+  constexpr std::size_t N = impl::static_size<std::remove_cv_t<R>>();
+  constexpr std::size_t M = impl::static_size<std::remove_cv_t<O>>();
+  static_assert( N == M || N == impl::dynamic_size
+                        || M == impl::dynamic_size,
+                 "transform output must have the size of the input");
+  using T = std::remove_cvref_t<decltype(*out.data())>;
+  auto const p = r.data();
+  auto const q = out.data();
+  impl::par_chunks<T, N != impl::dynamic_size ? N : M>(
+    pol, q, r.size(),
+    [p, q, &f](std::size_t, std::size_t b, std::size_t e) {
+      for (std::size_t i = b; i != e; ++i)
+        q[i] = f(p[i]);
+    });
+}
+
+// transform_reduce(pol, r, init, op, f) : init op f(r[0]) op f(r[1])
+//                  ..., by chunks in parallel, combined in order
+template <typename P, typename R, typename T, typename Op, typename F>
+  requires impl::par_range<R>
+T transform_reduce(P const& pol, R& r, T init, Op op, F f)
+{
+  using E = std::remove_cvref_t<decltype(*r.data())>;
+  constexpr std::size_t N = impl::static_size<std::remove_cv_t<R>>();
+  auto const p = r.data();
+  std::size_t const n = r.size();
+
+  auto combine = [&](auto& parts) {
+    impl::par_chunks<E, N>(pol, p, n,
+      [p, &op, &f, &parts](std::size_t k, std::size_t b,
+                                               std::size_t e) {
+        T acc = f(p[b]);
+        for (std::size_t i = b + 1; i != e; ++i)
+          acc = op(std::move(acc), f(p[i]));
+        parts[k].value.emplace(std::move(acc));
+      });
+    for (auto& part : parts)
+      if (part.value)
+        init = op(std::move(init), std::move(*part.value));
+    return init;
+  };
+
+  // A static chunk count keeps the partials on the stack
+  using Chunks = decltype(pol.chunks);
+  if constexpr (N != impl::dynamic_size && metaconst<Chunks>) {
+    using plan = impl::static_chunks<N, std::size_t(Chunks::value),
+                                     impl::line_elements<E>>;
+    std::array<impl::partial<T>, plan::count> parts;
+    return combine(parts);
+  }
+  else {
+    std::vector<impl::partial<T>> parts(
+                                      impl::chunk_count<E, N>(pol, n));
+    return combine(parts);
+  }
+}
+
+// reduce(pol, r, init, op) : init op r[0] op r[1] ..., in parallel
+template <typename P, typename R, typename T, typename Op = std::plus<>>
+  requires impl::par_range<R>
+T reduce(P const& pol, R& r, T init, Op op = {})
+{
+  return transform_reduce(pol, r, std::move(init), op,
+                          [](auto const& e) -> decltype(auto) {
+                            return e;
+                          });
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#undef NUA
+#pragma pop_macro("NUA")
+
+#endif
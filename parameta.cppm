@@ -0,0 +1,49 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+/*
+  parameta.cppm
+  =============
+  C++20 named module interface for "parameta.hpp" and its concepts and
+  traits, "parameta_traits.hpp"; parsed once per build, not per TU:
+
+    import parameta;
+
+  Configuration macros apply when the module interface is compiled, and
+  are fixed for all importers:
+
+    NAMESPACE_ID       the namespace of the exported names, default lml
+    METADATA_ACCESS_H  the in-class metadata API, "metadata_access.h"
+
+  e.g. -DNAMESPACE_ID=mylib, as set by the meson 'namespace_id' option.
+  Macros aren't exported, so importers that spell the namespace as
+  NAMESPACE_ID must define it to match.
+
+  The std headers are included in the global module fragment, so are
+  attached to the global module and not re-exported; the library header
+  is then included in an export block, so exports all its declarations.
+  Its own includes of the std headers are then skipped by their guards.
+
+  The header itself is also importable as a header unit,
+
+    import "parameta.hpp";
+
+  as it depends only on std headers and the configuration macros;
+  compile it with -DLML_PARAMETA_MODULE, as defined here, for GCC 12.
+*/
+
+module;
+
+#include <type_traits>
+#include <utility>
+
+export module parameta;
+
+#define LML_PARAMETA_MODULE // see parameta_traits.hpp
+
+export {
+#include "parameta.hpp"
+}
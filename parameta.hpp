@@ -96,6 +96,25 @@
   * M::meta(f) returns f.template operator()<x...>();
 */
 
+/* Local macros
+  The macros defined below are local to this header; each is saved by
+  push_macro and restored by pop_macro at the end of the header, so any
+  user definitions are left as they were, and none leak, e.g. from a
+  precompiled header. CONSTEVAL, STATIC_CALL and STATIC_CALL_CV may be
+  predefined to override their defaults; typeof, MSVCONST and
+  STATICMETA_V_X are always the library's own definitions.
+*/
+#pragma push_macro("METADATA_ACCESS_H")
+#pragma push_macro("CONSTEVAL")
+#pragma push_macro("STATIC_CALL")
+#pragma push_macro("STATIC_CALL_CV")
+#pragma push_macro("typeof")
+#pragma push_macro("MSVCONST")
+#pragma push_macro("STATICMETA_V_X")
+#undef typeof
+#undef MSVCONST
+#undef STATICMETA_V_X
+
 /* METADATA_ACCESS_H
   In-class accessors are not necessary, as x... is part of the type.
   They're a convenience. meta(f) assists generic out-of-class access.
@@ -123,35 +142,38 @@
 #if ! defined (STATIC_CALL)
 #  if defined (__cpp_static_call_operator)
 #     define STATIC_CALL static
-#     define STATIC_CALL_CV
 #  else
 #     define STATIC_CALL
+#  endif
+#endif
+#if ! defined (STATIC_CALL_CV)
+#  if defined (__cpp_static_call_operator)
+#     define STATIC_CALL_CV
+#  else
 #     define STATIC_CALL_CV const
 #  endif
 #endif
 
 // typeof(T) convenience, is in C23, possibly in C++26
-#ifndef typeof
-# ifdef _MSC_VER
-#  define typeof(...)std::remove_reference_t<decltype(__VA_ARGS__)>
-# else
-#  define typeof(...)__typeof(__VA_ARGS__)
-# endif
+#ifdef _MSC_VER
+# define typeof(...)std::remove_reference_t<decltype(__VA_ARGS__)>
+#else
+# define typeof(...)__typeof(__VA_ARGS__)
 #endif
 
 // MSVCONST(x) : MSVC sometimes seems to need NTTP const_cast
-#ifndef MSVCONST
-# ifdef _MSC_VER
-#  define MSVCONST(X) const_cast<typeof(X)const&>(X)
-# else
-#  define MSVCONST(X)X
-# endif
+#ifdef _MSC_VER
+# define MSVCONST(X) const_cast<typeof(X)const&>(X)
+#else
+# define MSVCONST(X)X
 #endif
 
 /* ****************************************************************** */
 
 #include "parameta_traits.hpp"
 
+#include <utility> // index_sequence, for metaget indexing
+
 #include "namespace.hpp" // open namespace LML_NAMESPACE_ID
 
 // Class declarations; typemeta, dynameta, staticmeta
@@ -163,6 +185,48 @@ template <decltype(auto), decltype(auto)...> struct staticmeta;
 template <typename T, T v, decltype(auto)...x> using staticmetacast
                                                    = staticmeta<v,x...>;
 
+/* ****************************************************************** */
+
+namespace impl {
+
+// meta_at<i, T...> : the i'th type in pack T... by flat overload-set
+//                    selection; meta_list derives from one meta_leaf
+//                    per type, tagged by index, and meta_select<i>
+//                    deduces T from the unique meta_leaf<i,T> base.
+//                    Instantiation depth is constant, not O(i), and
+//                    the T... types are named but not instantiated.
+template <std::size_t, typename> struct meta_leaf {};
+
+template <typename, typename...> struct meta_list;
+template <std::size_t...I, typename...T>
+struct meta_list<std::index_sequence<I...>, T...> : meta_leaf<I,T>... {};
+
+template <std::size_t i, typename T>
+auto meta_select(meta_leaf<i,T> const*) -> T;
+
+template <std::size_t i, typename...T>
+using meta_at = decltype(meta_select<i>(
+        static_cast<meta_list<std::index_sequence_for<T...>,T...>*>(0)));
+
+#if __cpp_concepts
+// access_counted<M> : runtime access instrumentation of metavalue M,
+//                     false unless specialized by "instrument.hpp";
+//                     if true, the value access operators call
+//                     count_access<M>(), for access_counter<M>::count()
+template <typename M> inline constexpr bool access_counted = false;
+
+template <typename M> struct access_counter;
+
+template <typename M>
+constexpr void count_access() noexcept
+{
+  if (! std::is_constant_evaluated())
+    access_counter<M>::count();
+}
+#endif
+
+} // impl
+
 /* ****************************************************************** */
 /* staticmeta<v,x...> std::integral_constant<T,v> minus T plus x...
                     - eliminates the unneccessary type parameter T
@@ -185,9 +249,26 @@ struct staticmeta
   using value_type = decltype(v); // may be an lvalue ref
                                  // but not an rvalue ref
   static constexpr value_type value = v;
+#if __cpp_concepts
+  STATIC_CALL
+  CONSTEVAL value_type operator()() STATIC_CALL_CV noexcept
+    requires (! impl::access_counted<staticmeta>) {return v;}
+  CONSTEVAL operator value_type() const noexcept
+    requires (! impl::access_counted<staticmeta>) {return v;}
+
+  // Instrumented access, not consteval, if on by "instrument.hpp"
+  STATIC_CALL
+  constexpr value_type operator()() STATIC_CALL_CV noexcept
+    requires impl::access_counted<staticmeta>
+  { impl::count_access<staticmeta>(); return v; }
+  constexpr operator value_type() const noexcept
+    requires impl::access_counted<staticmeta>
+  { impl::count_access<staticmeta>(); return v; }
+#else
   STATIC_CALL
   CONSTEVAL value_type operator()() STATIC_CALL_CV noexcept {return v;}
   CONSTEVAL operator value_type() const noexcept {return v;}
+#endif
 
 #if __has_include(METADATA_ACCESS_H)
 # include METADATA_ACCESS_H
@@ -213,8 +294,23 @@ struct dynameta
 
   value_type value;
 
+#if __cpp_concepts
+  constexpr value_type operator()() const noexcept
+  {
+    if constexpr (impl::access_counted<dynameta>)
+      impl::count_access<dynameta>();
+    return value;
+  }
+  constexpr operator value_type() const noexcept
+  {
+    if constexpr (impl::access_counted<dynameta>)
+      impl::count_access<dynameta>();
+    return value;
+  }
+#else
   constexpr value_type operator()() const noexcept {return value;}
   constexpr operator value_type() const noexcept {return value;}
+#endif
 
 #if __has_include(METADATA_ACCESS_H)
 # include METADATA_ACCESS_H
@@ -280,10 +376,27 @@ std::enable_if_t<
 
 #include "namespace.hpp" // close configurable namespace
 
+#undef METADATA_ACCESS_H
+#undef CONSTEVAL
+#undef STATIC_CALL
+#undef STATIC_CALL_CV
 #undef typeof
 #undef MSVCONST
-#undef STATIC_CALL
-#undef CONSTEVAL
-#undef METADATA_ACCESS_H
+#undef STATICMETA_V_X
+#pragma pop_macro("METADATA_ACCESS_H")
+#pragma pop_macro("CONSTEVAL")
+#pragma pop_macro("STATIC_CALL")
+#pragma pop_macro("STATIC_CALL_CV")
+#pragma pop_macro("typeof")
+#pragma pop_macro("MSVCONST")
+#pragma pop_macro("STATICMETA_V_X")
+
+#ifdef LML_PARAMETA_EXTERN
+# include "parameta_extern.hpp"
+#endif
+
+#if defined (LML_PARAMETA_INSTRUMENT) && __cpp_concepts
+# include "instrument.hpp"
+#endif
 
 #endif
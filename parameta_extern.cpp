@@ -0,0 +1,20 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+/*
+  parameta_extern.cpp
+  ===================
+  The explicit instantiation definitions for "parameta_extern.hpp";
+  the one TU that emits the prebuilt dynameta<T> member functions,
+  linked into every program built with LML_PARAMETA_EXTERN defined.
+*/
+
+#define LML_PARAMETA_EXTERN_DEFINITIONS
+#ifndef LML_PARAMETA_EXTERN
+#define LML_PARAMETA_EXTERN
+#endif
+
+#include "parameta.hpp"
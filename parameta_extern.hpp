@@ -0,0 +1,121 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_PARAMETA_EXTERN_HPP
+#define LML_PARAMETA_EXTERN_HPP
+
+/*
+  parameta_extern.hpp
+  ===================
+  Opt-in prebuilt specializations, for builds of many TUs that each use
+  the same few dynameta and staticmeta types; included at the end of
+  "parameta.hpp" if LML_PARAMETA_EXTERN is defined, e.g. by the meson
+  option 'extern_templates', which also builds "parameta_extern.cpp":
+
+  * extern template dynameta<T>, for the arithmetic types T, so their
+    member functions are only emitted once, in parameta_extern.cpp, in
+    place of a COMDAT copy per TU, for the linker to fold
+
+  * precomputed meta_kind, the classification read by all the concepts
+    and traits, for the same dynameta<T>, and, from C++20, for integral
+    staticmeta<v> of int, or of size_t if MIN <= 0, value in the range
+
+      LML_PARAMETA_PRECOMPUTED_MIN <= v <= LML_PARAMETA_PRECOMPUTED_MAX
+
+    default 0 to 64, so that is_metavalue_v, metaconst and the rest are
+    answered without the structural and value access checks.
+
+  Types with metadata are not covered; their checks are as before.
+  Every TU of a program must agree on LML_PARAMETA_EXTERN, and the
+  program must link parameta_extern.cpp, built with the same settings.
+*/
+
+#ifndef LML_PARAMETA_PRECOMPUTED_MIN
+#define LML_PARAMETA_PRECOMPUTED_MIN 0
+#endif
+#ifndef LML_PARAMETA_PRECOMPUTED_MAX
+#define LML_PARAMETA_PRECOMPUTED_MAX 64
+#endif
+
+#pragma push_macro("EXTERN_TEMPLATE")
+#pragma push_macro("PREBUILT")
+#undef EXTERN_TEMPLATE
+#undef PREBUILT
+#ifdef LML_PARAMETA_EXTERN_DEFINITIONS
+# define EXTERN_TEMPLATE template       // in parameta_extern.cpp
+#else
+# define EXTERN_TEMPLATE extern template
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// dynamic_value_kind, const_value_kind : meta_kind of a dynamic, or a
+//                                         metaconst, metavalue
+struct dynamic_value_kind
+{
+  static constexpr bool is_value = true;
+  static constexpr bool is_static = false;
+  static constexpr bool is_const = false;
+  static constexpr bool is_type = false;
+};
+
+struct const_value_kind
+{
+  static constexpr bool is_value = true;
+  static constexpr bool is_static = true;
+  static constexpr bool is_const = true;
+  static constexpr bool is_type = false;
+};
+
+#if __cpp_concepts
+// The value type is checked first, so that staticmeta<(g)> ids of
+// globals, and other types of value, aren't compared with the bounds
+template <decltype(auto) v>
+  requires std::is_same_v<decltype(v), int>
+        && (LML_PARAMETA_PRECOMPUTED_MIN <= v
+         && v <= LML_PARAMETA_PRECOMPUTED_MAX)
+struct meta_kind<staticmeta<v>> : const_value_kind {};
+
+template <decltype(auto) v>
+  requires std::is_same_v<decltype(v), std::size_t>
+        && (LML_PARAMETA_PRECOMPUTED_MIN <= 0
+         && v <= std::size_t(LML_PARAMETA_PRECOMPUTED_MAX))
+struct meta_kind<staticmeta<v>> : const_value_kind {};
+#endif
+
+} // impl
+
+// PREBUILT(T) : precomputed meta_kind and extern template dynameta<T>
+#define PREBUILT(...) \
+  namespace impl { template <> struct meta_kind<dynameta<__VA_ARGS__>> \
+                                        : dynamic_value_kind {}; } \
+  EXTERN_TEMPLATE struct dynameta<__VA_ARGS__>;
+
+PREBUILT(bool)
+PREBUILT(char)
+PREBUILT(signed char)
+PREBUILT(unsigned char)
+PREBUILT(short)
+PREBUILT(unsigned short)
+PREBUILT(int)
+PREBUILT(unsigned)
+PREBUILT(long)
+PREBUILT(unsigned long)
+PREBUILT(long long)
+PREBUILT(unsigned long long)
+PREBUILT(float)
+PREBUILT(double)
+
+#include "namespace.hpp" // close configurable namespace
+
+#undef EXTERN_TEMPLATE
+#undef PREBUILT
+#pragma pop_macro("EXTERN_TEMPLATE")
+#pragma pop_macro("PREBUILT")
+
+#endif
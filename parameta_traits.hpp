@@ -97,6 +97,13 @@
   is dynamic, constexpr or a static variable, without specializations.
 */
 
+#pragma push_macro("SAME")
+#pragma push_macro("REMOVE_REF_T")
+#pragma push_macro("REMOVE_CVREF_T")
+#undef SAME
+#undef REMOVE_REF_T
+#undef REMOVE_CVREF_T
+
 #define SAME std::is_same_v
 
 #define REMOVE_REF_T(...) std::remove_reference_t<__VA_ARGS__>
@@ -114,8 +121,9 @@ namespace impl {
 
 // ftor_ret_or_fail<L> : the return type R of L::operator()()const -> R
 //                                            if it exists, else fail
+//  (L is taken as is, not cvref-stripped; meta values are class types)
 template <typename L> using ftor_ret_or_fail
-  = decltype(std::declval<REMOVE_CVREF_T(L) const>().operator()());
+  = decltype(std::declval<L const>().operator()());
 
 template <typename L> void ftor_ret_or_void(...);
 template <typename L> auto ftor_ret_or_void(int) -> ftor_ret_or_fail<L>;
@@ -169,6 +177,19 @@ template <auto f> concept structural_functor
 
 template <auto f> concept structural_value_functor
                         = structural_value_or_fail<element0(f())>{true};
+
+// is_structural_functor_v<L>, is_structural_value_functor_v<L> as above
+//   for f = L{}, with invalid L{} a substitution failure; i.e. false
+//
+template <typename L> concept structural_functor_type
+                            = structural_functor<L{}>;
+template <typename L> concept structural_value_functor_type
+                            = structural_value_functor<L{}>;
+
+template <typename L> inline constexpr bool
+            is_structural_functor_v = structural_functor_type<L>;
+template <typename L> inline constexpr bool
+      is_structural_value_functor_v = structural_value_functor_type<L>;
 #else
 template <typename L, typename = void>
 inline constexpr bool is_structural_functor_v = false;
@@ -190,6 +211,111 @@ constexpr bool structural_non_value(T...) {return true;}
 template <auto>
 constexpr bool structural_non_value() {return false;}
 
+// implicit_to<T>(q) is well-formed if q is implicitly convertible to T;
+//                   as std::is_convertible_v but far cheaper to check
+template <typename T> void implicit_to(T) noexcept;
+
+// value_access<Q,R> : Q has the access API of integral_constant with
+//                     call operator return type R (see metavalue below)
+//
+#if __cpp_concepts
+template <typename Q, typename R>
+concept value_access
+   = SAME<REMOVE_CVREF_T(R), REMOVE_CVREF_T(typename Q::value_type)>
+ && SAME<value_return_type<Q>, R>
+ && (SAME<typename Q::value_type,std::remove_cv_t<decltype(Q::value)>>
+  || SAME<typename Q::value_type, decltype(Q::value)>)
+ && requires (Q const q) { implicit_to<typename Q::value_type>(q); };
+
+#else
+template <typename Q, typename R, typename = REMOVE_CVREF_T(R)>
+inline constexpr bool value_access = false;
+
+template <typename Q, typename R>
+inline constexpr bool value_access<Q, R,
+    REMOVE_CVREF_T(decltype(
+      implicit_to<typename Q::value_type>(std::declval<Q const>()),
+      typename Q::value_type(Q::value)))>
+  =
+    SAME<value_return_type<Q>, R>
+ && (SAME<typename Q::value_type,std::remove_cv_t<decltype(Q::value)>>
+  || SAME<typename Q::value_type, decltype(Q::value)>);
+#endif
+
+// has_type_member<Q> : Q has a member type alias 'type'
+#if __cpp_concepts
+template <typename Q>
+concept has_type_member = requires { typename Q::type; };
+#else
+template <typename Q, typename = void>
+inline constexpr bool has_type_member = false;
+template <typename Q>
+inline constexpr bool has_type_member<Q, std::void_t<typename Q::type>>
+                                     = true;
+#endif
+
+// static_kind<Q, value&&empty> : Q{}() is structural
+// const_kind<Q, static>        : Q{}() is a structural value
+// type_kind<Q, type&&empty>    : Q has no call operator
+//   each is only evaluated if its bool argument, the precondition, holds
+//
+#ifndef LML_PARAMETA_MODULE
+template <typename Q, bool> inline constexpr bool static_kind = false;
+template <typename Q> inline constexpr bool static_kind<Q,true>
+                                   = is_structural_functor_v<Q>;
+
+template <typename Q, bool> inline constexpr bool const_kind = false;
+template <typename Q> inline constexpr bool const_kind<Q,true>
+                                   = is_structural_value_functor_v<Q>;
+
+template <typename Q, bool> inline constexpr bool type_kind = false;
+template <typename Q> inline constexpr bool type_kind<Q,true>
+                                   = ! has_call_op_const<Q>;
+#else
+// Variable template partial specializations are not visible to module
+// importers with GCC 12 -fmodules-ts, so the module interface compiles
+// the gates as class templates instead, at some compile-time cost
+template <typename Q, bool> struct static_gate { enum : bool {v = 0}; };
+template <typename Q> struct static_gate<Q,true>
+  { enum : bool {v = is_structural_functor_v<Q>}; };
+
+template <typename Q, bool> struct const_gate { enum : bool {v = 0}; };
+template <typename Q> struct const_gate<Q,true>
+  { enum : bool {v = is_structural_value_functor_v<Q>}; };
+
+template <typename Q, bool> struct type_gate { enum : bool {v = 0}; };
+template <typename Q> struct type_gate<Q,true>
+  { enum : bool {v = ! has_call_op_const<Q>}; };
+
+template <typename Q, bool b> inline constexpr bool static_kind
+                                             = static_gate<Q,b>::v;
+template <typename Q, bool b> inline constexpr bool const_kind
+                                             = const_gate<Q,b>::v;
+template <typename Q, bool b> inline constexpr bool type_kind
+                                             = type_gate<Q,b>::v;
+#endif
+
+// meta_kind<Q> : classification of Q as metatype or meta value kind,
+//   computed once per Q and read by all the concepts and traits below;
+//   each meta value level is checked only if the one below it holds
+//
+template <typename Q>
+struct meta_kind
+{
+  static constexpr bool is_value
+                          = value_access<Q, functor_return_or_void<Q>>;
+  static constexpr bool is_static
+                      = static_kind<Q, is_value && std::is_empty_v<Q>>;
+  static constexpr bool is_const = const_kind<Q, is_static>;
+  static constexpr bool is_type
+                  = type_kind<Q, has_type_member<Q> && std::is_empty_v<Q>>;
+};
+
+// value_type_or_void<Q> : the unqualified return type of Q::operator()
+//                     ()const, or void; default V of the value concepts
+template <typename Q>
+using value_type_or_void = REMOVE_CVREF_T(functor_return_or_void<Q>);
+
 } // impl;
 
 /* ********** metavalue < metastatic < metaconst ************ */
@@ -205,32 +331,17 @@ constexpr bool structural_non_value() {return false;}
 //   and is implicitly const-convertible to value_type
 //
 #if __cpp_concepts
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
-concept metavalue = SAME<V, REMOVE_CVREF_T(typename Q::value_type)>
- &&
-    SAME<impl::value_return_type<Q>, impl::functor_return_or_void<Q>>
- && (SAME<typename Q::value_type,std::remove_cv_t<decltype(Q::value)>>
-  || SAME<typename Q::value_type, decltype(Q::value)>)
- && std::is_convertible_v<Q const, typename Q::value_type>;
+template <typename Q, typename V = impl::value_type_or_void<Q>>
+concept metavalue = impl::meta_kind<Q>::is_value
+                 && SAME<V, impl::value_type_or_void<Q>>;
 
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
+template <typename Q, typename V = impl::value_type_or_void<Q>>
 inline constexpr bool is_metavalue_v = metavalue<Q,V>;
 
 #else
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
-inline constexpr bool is_metavalue_v = false;
-
-template <typename Q>
-inline constexpr bool is_metavalue_v<Q,
-    REMOVE_CVREF_T(decltype(typename Q::value_type(Q::value)))>
-  =
-    SAME<impl::value_return_type<Q>, impl::functor_return_or_void<Q>>
- && (SAME<typename Q::value_type,std::remove_cv_t<decltype(Q::value)>>
-  || SAME<typename Q::value_type, decltype(Q::value)>)
- && std::is_convertible_v<Q const, typename Q::value_type>;
+template <typename Q, typename V = impl::value_type_or_void<Q>>
+inline constexpr bool is_metavalue_v = impl::meta_kind<Q>::is_value
+                             && SAME<V, impl::value_type_or_void<Q>>;
 #endif
 
 // metastatic <Q, V = see-above*> 'static meta-value' concept
@@ -238,22 +349,17 @@ inline constexpr bool is_metavalue_v<Q,
 //   and is itself a default constructible empty type
 //
 #if __cpp_concepts
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
+template <typename Q, typename V = impl::value_type_or_void<Q>>
 concept metastatic = metavalue<Q,V>
-             && std::is_empty_v<Q>
-             && impl::structural_functor<Q{}>;
+             && impl::meta_kind<Q>::is_static;
 
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
+template <typename Q, typename V = impl::value_type_or_void<Q>>
 inline constexpr bool is_metastatic_v = metastatic<Q,V>;
 
 #else
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
-inline constexpr bool is_metastatic_v = is_metavalue_v<Q,V>
-                                && std::is_empty_v<Q>
-                                && impl::is_structural_functor_v<Q>;
+template <typename Q, typename V = impl::value_type_or_void<Q>>
+inline constexpr bool is_metastatic_v = impl::meta_kind<Q>::is_static
+                             && SAME<V, impl::value_type_or_void<Q>>;
 #endif
 
 // metaconst <Q, V = see-above*> 'pure static meta-value' concept
@@ -261,20 +367,17 @@ inline constexpr bool is_metastatic_v = is_metavalue_v<Q,V>
 //   i.e. constexpr value and value_type is a structural type
 //
 #if __cpp_concepts
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
+template <typename Q, typename V = impl::value_type_or_void<Q>>
 concept metaconst = metastatic<Q,V>
-              && impl::structural_value_functor<Q{}>;
+              && impl::meta_kind<Q>::is_const;
 
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
+template <typename Q, typename V = impl::value_type_or_void<Q>>
 inline constexpr bool is_metaconst_v = metaconst<Q,V>;
 
 #else
-template <typename Q,
-          typename V = REMOVE_CVREF_T(impl::functor_return_or_void<Q>)>
-inline constexpr bool is_metaconst_v = is_metastatic_v<Q,V>
-                              && impl::is_structural_value_functor_v<Q>;
+template <typename Q, typename V = impl::value_type_or_void<Q>>
+inline constexpr bool is_metaconst_v = impl::meta_kind<Q>::is_const
+                             && SAME<V, impl::value_type_or_void<Q>>;
 #endif
 
 /* ************** 'metatype' meta-type concept ******************* */
@@ -285,21 +388,14 @@ inline constexpr bool is_metaconst_v = is_metastatic_v<Q,V>
 //
 #if __cpp_concepts
 template <typename Q>
-concept metatype = requires { typename Q::type; }
-            && std::is_empty_v<Q>
-            && ! impl::has_call_op_const<Q>;
+concept metatype = impl::meta_kind<Q>::is_type;
 
 template <typename Q, typename = void>
 inline constexpr bool is_metatype_v = metatype<Q>;
 
 #else
 template <typename Q, typename = void>
-inline constexpr bool is_metatype_v = false;
-
-template <typename Q>
-inline constexpr bool is_metatype_v<Q, std::void_t<typename Q::type>>
-                                    = std::is_empty_v<Q>
-                                   && ! impl::has_call_op_const<Q>;
+inline constexpr bool is_metatype_v = impl::meta_kind<Q>::is_type;
 #endif
 
 /* ************** 'metapara' meta-parameter concept ***************** */
@@ -315,8 +411,8 @@ inline constexpr bool is_metapara_v = metapara<Q>;
 
 #else
 template <typename Q, typename = void>
-inline constexpr bool is_metapara_v = is_metatype_v<Q>
-                                   || is_metavalue_v<Q>;
+inline constexpr bool is_metapara_v = impl::meta_kind<Q>::is_type
+                                   || impl::meta_kind<Q>::is_value;
 #endif
 
 #include "namespace.hpp" // close configurable namespace
@@ -324,5 +420,8 @@ inline constexpr bool is_metapara_v = is_metatype_v<Q>
 #undef SAME
 #undef REMOVE_REF_T
 #undef REMOVE_CVREF_T
+#pragma pop_macro("SAME")
+#pragma pop_macro("REMOVE_REF_T")
+#pragma pop_macro("REMOVE_CVREF_T")
 
 #endif
@@ -0,0 +1,193 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_RAY_HPP
+#define LML_RAY_HPP
+
+/*
+  ray.hpp
+  =======
+  A generic array type, parameterized by a Storage type and a metavalue
+  Extent type, as in the readme example usage; one definition serves as
+  a static array, a static span or a dynamic span, with no overhead.
+
+  * ray<Storage,Extent> : aggregate of Storage storage; Extent extent;
+                          [[no_unique_address]] so empty types are free
+
+    Storage has array-like access via the subscript operator[], e.g.
+            T[N]              array, in-class 'intrinsic' storage
+            T(&)[N], T*       reference or pointer to extrinsic storage
+            unique_ptr<T[]>   owning pointer, or other fancy pointer
+            staticmeta<(buf)> static id of a static buffer, zero size
+
+    Extent is a metavalue of integral value_type, e.g.
+            staticmeta<N>     metaconst size, constant-folded
+            staticmeta<(n)>   metastatic size, a static global variable
+            dynameta<int>     dynamic size, a data member
+
+  Access API, begin(), end(), data(), size(), empty() and operator[],
+  is in terms of the data() pointer and size(). data() is static if the
+  Storage is metastatic, and size() is static if Extent is metastatic,
+  so constexpr if metaconst.
+
+  Alignment
+  =========
+  An alignment request is carried as Extent metadata align<A>, e.g.
+  staticmeta<N, align<64>> or dynameta<int, align<32>>, for vector loads
+  of whole aligned blocks:
+
+  * An in-class array is aligned, with the ray padded, to A bytes
+  * data() returns std::assume_aligned<A>(pointer) to inform the
+    optimizer, and so asserts that any extrinsic storage is aligned
+
+     ray<float[8], staticmeta<8, align<32>>> v{};  // one 32-byte vector
+
+  Requires C++20 concepts.
+*/
+
+#include "parameta.hpp"
+
+#include <memory> // to_address, assume_aligned
+
+#if ! __cpp_concepts
+# error "ray.hpp requires C++20 concepts"
+#endif
+
+#pragma push_macro("NUA")
+#undef NUA
+#ifndef _MSC_VER
+# define NUA [[no_unique_address]]
+#else
+# define NUA [[msvc::no_unique_address]]
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+// align<A> : alignment request metadata tag value, e.g. staticmeta<N,
+//            align<64>>, carried as an empty cNTTP of type align_t<A>
+template <std::size_t A>
+  requires (A != 0 && (A & (A - 1)) == 0)
+struct align_t { static constexpr std::size_t value = A; };
+
+template <std::size_t A> inline constexpr align_t<A> align{};
+
+namespace impl {
+
+template <std::size_t A>
+constexpr std::size_t align_of(align_t<A> const&) noexcept {return A;}
+template <typename X>
+constexpr std::size_t align_of(X const&) noexcept {return 1;}
+
+// meta_align<M> : the largest align<A> in the metadata of M, else 1
+template <typename> inline constexpr std::size_t meta_align = 1;
+
+template <std::size_t...a>
+constexpr std::size_t max_align() noexcept {
+  std::size_t m = 1;
+  ((m = a > m ? a : m), ...);
+  return m;
+}
+template <decltype(auto) v, decltype(auto)...x>
+inline constexpr std::size_t meta_align<staticmeta<v,x...>>
+                                    = max_align<align_of(x)...>();
+template <typename T, decltype(auto)...x>
+inline constexpr std::size_t meta_align<dynameta<T,x...>>
+                                    = max_align<align_of(x)...>();
+
+// ray_align<S,E> : alignas value for ray<S,E>, its natural alignment
+//                  or the requested alignment, for in-class arrays
+template <typename M> inline constexpr std::size_t member_align
+  = alignof(std::conditional_t<std::is_reference_v<M>,
+                               std::remove_reference_t<M>*, M>);
+
+template <typename S, typename E>
+inline constexpr std::size_t ray_align = max_align<
+      member_align<S>, member_align<E>,
+      std::is_array_v<S> ? meta_align<E> : 1>();
+
+// ray_data(s) : pointer to the first element of storage s
+template <typename S>
+constexpr auto ray_data(S& s) noexcept
+{
+  if constexpr (metastatic<std::remove_cv_t<S>>)
+    return ray_data(S::value);
+  else if constexpr (std::is_array_v<S>)
+    return static_cast<std::remove_extent_t<S>*>(s);
+  else if constexpr (requires { s.get(); })
+    return s.get();
+  else
+    return std::to_address(s);
+}
+
+// assume_aligned<A>(p) : std::assume_aligned, if available and A > 1
+template <std::size_t A, typename P>
+constexpr P assume_aligned(P p) noexcept
+{
+#if __cpp_lib_assume_aligned
+  if constexpr (A > 1)
+    return std::assume_aligned<A>(p);
+  else
+#endif
+    return p;
+}
+
+} // impl
+
+template <typename Storage, metavalue Extent>
+  requires (std::is_integral_v<
+                 std::remove_cvref_t<typename Extent::value_type>>
+         && requires (Storage a) {a[0];})
+struct alignas(impl::ray_align<Storage,Extent>)
+ray
+{
+  NUA Storage storage;
+  NUA Extent extent{};
+
+  using size_type = std::size_t;
+  using pointer = decltype(impl::ray_data(std::declval<Storage&>()));
+  using element_type = std::remove_pointer_t<pointer>;
+  using value_type = std::remove_cv_t<element_type>;
+  using iterator = pointer;
+
+  // alignment : the requested alignment, from Extent metadata align<A>
+  static constexpr size_type alignment = impl::meta_align<Extent>;
+
+  static constexpr auto data() noexcept requires metastatic<Storage>
+                       { return impl::assume_aligned<alignment>(
+                                impl::ray_data(Storage::value)); }
+  constexpr auto data() noexcept requires (!metastatic<Storage>)
+                       { return impl::assume_aligned<alignment>(
+                                impl::ray_data(storage)); }
+  constexpr auto data() const noexcept requires (!metastatic<Storage>)
+                       { return impl::assume_aligned<alignment>(
+                                impl::ray_data(storage)); }
+
+  static constexpr size_type size() noexcept
+                       requires metastatic<Extent>
+                       { return Extent::value; }
+  constexpr size_type size() const noexcept
+                       requires (!metastatic<Extent>)
+                       { return extent(); }
+
+  constexpr bool empty() const noexcept { return size() == 0; }
+
+  constexpr auto begin() noexcept { return data(); }
+  constexpr auto begin() const noexcept { return data(); }
+  constexpr auto end() noexcept { return data() + size(); }
+  constexpr auto end() const noexcept { return data() + size(); }
+
+  constexpr decltype(auto) operator[](size_type i) noexcept
+                                               { return data()[i]; }
+  constexpr decltype(auto) operator[](size_type i) const noexcept
+                                               { return data()[i]; }
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#undef NUA
+#pragma pop_macro("NUA")
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_RAY_VIEW_HPP
+#define LML_RAY_VIEW_HPP
+
+/*
+  ray_view.hpp
+  ============
+  Strided, reversed and gathered views over a ray, without copies, in
+  which offset, stride and count are each a metavalue; static parts of
+  the layout take no storage and constant-fold, through composition:
+
+  * strided_view<P,O,S,N> : element i is base[o + s*i], for i < n, of
+                            offset O, stride S and count N metavalues
+  * gather_view<P,I,O,S>  : element i is base[o + s*index[i]], for an
+                            index view I, a view of integral elements
+
+    P, the base, is an element pointer or a metastatic storage id, the
+    staticmeta<(buf)> Storage of a ray, of zero size
+
+  * view(r)              -> the whole of ray r, offset 0 and stride 1
+  * strided(r, o, s, n)  -> elements o, o + s, ..., o + s*(n-1) of r
+  * reversed(r)          -> the elements of r in reverse order
+  * gather(r, idx)       -> elements idx[0], idx[1], ... of r
+
+    Here r is a ray, or a view; o, s and n are metavalues or integers,
+    and idx is a ray or view of indices. A view of a view composes to
+    one index expression, in place of nested iterators; its offset and
+    stride are staticmeta values if both layouts are metaconst:
+
+      ray<float[64], staticmeta<64>> a{};
+      auto evens = strided(a, staticmeta<0>{}, staticmeta<2>{},
+                              staticmeta<32>{});
+      auto back = reversed(evens);   // a[62], a[60], ..., a[0]
+      static_assert( sizeof back == sizeof(float*) );
+
+  A stride of staticmeta<1> is contiguous, with pointer data(), begin()
+  and end(); otherwise begin() and end() are index iterators.
+
+  Views are non-owning, like span; the ray must outlive its views, and
+  a view of an rvalue ray with in-class array storage is deleted. There
+  is no bounds checking, as for ray.
+
+  Requires C++20 concepts.
+*/
+
+#include "ray.hpp"
+
+#include <cstddef>  // ptrdiff_t
+#include <iterator> // forward_iterator_tag
+
+#pragma push_macro("NUA")
+#undef NUA
+#ifndef _MSC_VER
+# define NUA [[no_unique_address]]
+#else
+# define NUA [[msvc::no_unique_address]]
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+// meta_index(m) : the value of metavalue m as a ptrdiff_t, read from
+//                 the type if metastatic
+template <typename M>
+constexpr std::ptrdiff_t meta_index(M const& m) noexcept
+{
+  if constexpr (metastatic<M>)
+    return static_cast<std::ptrdiff_t>(M::value);
+  else
+    return static_cast<std::ptrdiff_t>(m());
+}
+
+// meta_affine(a, b, c) : a metavalue of a + b*c; a staticmeta if all
+//                        are metaconst, c itself if a + b*c is 0 + 1*c,
+//                        else a dynameta<ptrdiff_t>
+template <typename A, typename B, typename C>
+constexpr auto meta_affine(A const& a, B const& b, C const& c) noexcept
+{
+  if constexpr (metaconst<A> && metaconst<B> && metaconst<C>)
+    return staticmeta<std::ptrdiff_t(A::value)
+                    + std::ptrdiff_t(B::value) * C::value>{};
+  else if constexpr (metaconst<A> && metaconst<B>) {
+    if constexpr (A::value == 0 && B::value == 1)
+      return c;
+    else
+      return dynameta<std::ptrdiff_t>{meta_index(a)
+                                    + meta_index(b) * meta_index(c)};
+  }
+  else
+    return dynameta<std::ptrdiff_t>{meta_index(a)
+                                  + meta_index(b) * meta_index(c)};
+}
+
+// as_meta(x) : x if a metavalue, else an integer x as a dynameta
+template <typename X>
+constexpr auto as_meta(X const& x) noexcept
+{
+  if constexpr (metavalue<X>)
+    return x;
+  else
+    return dynameta<std::ptrdiff_t>{static_cast<std::ptrdiff_t>(x)};
+}
+
+template <typename X>
+concept view_arg = metavalue<X> || std::is_integral_v<X>;
+
+// view_base(p) : the element pointer of base P, static if metastatic
+template <typename P>
+constexpr auto view_base(P const& p) noexcept
+{
+  if constexpr (metastatic<P>)
+    return ray_data(P::value);
+  else
+    return p;
+}
+
+// view_iterator<V> : a forward iterator of view V, by index
+template <typename V>
+struct view_iterator
+{
+  using iterator_category = std::forward_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = typename V::value_type;
+  using reference = typename V::element_type&;
+  using pointer = typename V::pointer;
+
+  V const* v = nullptr;
+  std::size_t i = 0;
+
+  constexpr reference operator*() const noexcept { return (*v)[i]; }
+  constexpr view_iterator& operator++() noexcept { ++i; return *this; }
+  constexpr view_iterator operator++(int) noexcept
+                                { auto t = *this; ++i; return t; }
+  friend constexpr bool operator==(view_iterator const& a,
+                                   view_iterator const& b) noexcept
+                                { return a.i == b.i; }
+};
+
+} // impl
+
+/* strided_view  *************************************************** */
+
+template <typename P, metavalue O, metavalue S, metavalue N>
+  requires (std::is_pointer_v<P> || metastatic<P>)
+struct strided_view
+{
+  NUA P base;
+  NUA O offset{};
+  NUA S stride{};
+  NUA N extent{};
+
+  using size_type = std::size_t;
+  using pointer = decltype(impl::view_base(std::declval<P const&>()));
+  using element_type = std::remove_pointer_t<pointer>;
+  using value_type = std::remove_cv_t<element_type>;
+
+  // contiguous : true if the stride is staticmeta<1>, pointer access
+  static constexpr bool contiguous = [] {
+    if constexpr (metaconst<S>)
+      return S::value == 1;
+    else
+      return false;
+  }();
+
+  static constexpr size_type size() noexcept requires metastatic<N>
+                       { return static_cast<size_type>(N::value); }
+  constexpr size_type size() const noexcept requires (!metastatic<N>)
+                       { return static_cast<size_type>(extent()); }
+
+  constexpr bool empty() const noexcept { return size() == 0; }
+
+  // index(i) : the offset of element i from the base pointer
+  constexpr std::ptrdiff_t index(size_type i) const noexcept
+  {
+    return impl::meta_index(offset) + impl::meta_index(stride)
+                                    * static_cast<std::ptrdiff_t>(i);
+  }
+
+  constexpr element_type& operator[](size_type i) const noexcept
+                       { return impl::view_base(base)[index(i)]; }
+
+  constexpr pointer data() const noexcept requires contiguous
+                       { return impl::view_base(base) + index(0); }
+
+  constexpr auto begin() const noexcept
+  {
+    if constexpr (contiguous)
+      return data();
+    else
+      return impl::view_iterator<strided_view>{this, 0};
+  }
+  constexpr auto end() const noexcept
+  {
+    if constexpr (contiguous)
+      return data() + size();
+    else
+      return impl::view_iterator<strided_view>{this, size()};
+  }
+};
+
+/* gather_view  **************************************************** */
+
+template <typename P, typename I, metavalue O, metavalue S>
+  requires (std::is_pointer_v<P> || metastatic<P>)
+struct gather_view
+{
+  NUA P base;
+  NUA I index_view;
+  NUA O offset{};
+  NUA S stride{};
+
+  using size_type = std::size_t;
+  using pointer = decltype(impl::view_base(std::declval<P const&>()));
+  using element_type = std::remove_pointer_t<pointer>;
+  using value_type = std::remove_cv_t<element_type>;
+
+  static constexpr bool contiguous = false;
+
+  static constexpr size_type size() noexcept
+                       requires requires { I::size(); }
+                       { return I::size(); }
+  constexpr size_type size() const noexcept
+                       requires (! requires { I::size(); })
+                       { return index_view.size(); }
+
+  constexpr bool empty() const noexcept { return size() == 0; }
+
+  // index(i) : the offset of element i from the base pointer
+  constexpr std::ptrdiff_t index(size_type i) const noexcept
+  {
+    return impl::meta_index(offset) + impl::meta_index(stride)
+                    * static_cast<std::ptrdiff_t>(index_view[i]);
+  }
+
+  constexpr element_type& operator[](size_type i) const noexcept
+                       { return impl::view_base(base)[index(i)]; }
+
+  constexpr auto begin() const noexcept
+              { return impl::view_iterator<gather_view>{this, 0}; }
+  constexpr auto end() const noexcept
+              { return impl::view_iterator<gather_view>{this, size()}; }
+};
+
+/* Composition  **************************************************** */
+
+// view(r) : an identity strided_view of ray r, or view r itself
+template <typename S, typename E>
+constexpr auto view(ray<S,E>& r) noexcept
+{
+  using O = staticmeta<0>;
+  using U = staticmeta<1>;
+  if constexpr (metastatic<S>)
+    return strided_view<S, O, U, E>{{}, {}, {}, r.extent};
+  else
+    return strided_view<decltype(r.data()), O, U, E>{
+                                         r.data(), {}, {}, r.extent};
+}
+template <typename S, typename E>
+constexpr auto view(ray<S,E> const& r) noexcept
+{
+  using O = staticmeta<0>;
+  using U = staticmeta<1>;
+  if constexpr (metastatic<S>)
+    return strided_view<S, O, U, E>{{}, {}, {}, r.extent};
+  else
+    return strided_view<decltype(r.data()), O, U, E>{
+                                         r.data(), {}, {}, r.extent};
+}
+// No view of a temporary in-class array; it would dangle
+template <typename S, typename E>
+  requires std::is_array_v<S>
+void view(ray<S,E> const&&) = delete;
+
+template <typename P, typename O, typename S, typename N>
+constexpr auto view(strided_view<P,O,S,N> const& v) noexcept
+{
+  return v;
+}
+template <typename P, typename I, typename O, typename S>
+constexpr auto view(gather_view<P,I,O,S> const& v) noexcept
+{
+  return v;
+}
+
+namespace impl {
+
+template <typename P, typename O, typename S, typename N,
+          typename Oi, typename Si, typename Ni>
+constexpr auto strided_of(strided_view<P,O,S,N> const& v,
+                          Oi const& o, Si const& s, Ni const& n)
+                                                              noexcept
+{
+  auto const off = meta_affine(v.offset, v.stride, o);
+  auto const str = meta_affine(staticmeta<0>{}, v.stride, s);
+  return strided_view<P, std::remove_const_t<decltype(off)>,
+                         std::remove_const_t<decltype(str)>, Ni>{
+                                             v.base, off, str, n};
+}
+template <typename P, typename I, typename O, typename S,
+          typename Oi, typename Si, typename Ni>
+constexpr auto strided_of(gather_view<P,I,O,S> const& v,
+                          Oi const& o, Si const& s, Ni const& n)
+                                                              noexcept
+{
+  auto const idx = strided_of(v.index_view, o, s, n);
+  return gather_view<P, std::remove_const_t<decltype(idx)>, O, S>{
+                                     v.base, idx, v.offset, v.stride};
+}
+
+template <typename P, typename O, typename S, typename N, typename X>
+constexpr auto gather_of(strided_view<P,O,S,N> const& v,
+                         X const& idx) noexcept
+{
+  return gather_view<P, X, O, S>{v.base, idx, v.offset, v.stride};
+}
+template <typename P, typename I, typename O, typename S, typename X>
+constexpr auto gather_of(gather_view<P,I,O,S> const& v,
+                         X const& idx) noexcept
+{
+  auto const inner = gather_of(v.index_view, idx);
+  return gather_view<P, std::remove_const_t<decltype(inner)>, O, S>{
+                                   v.base, inner, v.offset, v.stride};
+}
+
+// extent_of(v) : the count metavalue of view v
+template <typename P, typename O, typename S, typename N>
+constexpr N extent_of(strided_view<P,O,S,N> const& v) noexcept
+{
+  return v.extent;
+}
+template <typename P, typename I, typename O, typename S>
+constexpr auto extent_of(gather_view<P,I,O,S> const& v) noexcept
+{
+  return extent_of(v.index_view);
+}
+
+} // impl
+
+// strided(r, o, s, n) : a view of the n elements o + s*i of r
+template <typename R, impl::view_arg Oi, impl::view_arg Si,
+                      impl::view_arg Ni>
+  requires requires (R&& r) { view(static_cast<R&&>(r)); }
+constexpr auto strided(R&& r, Oi const& o, Si const& s, Ni const& n)
+                                                              noexcept
+{
+  return impl::strided_of(view(static_cast<R&&>(r)), impl::as_meta(o),
+                          impl::as_meta(s), impl::as_meta(n));
+}
+
+// reversed(r) : a view of the elements of r, last first
+template <typename R>
+  requires requires (R&& r) { view(static_cast<R&&>(r)); }
+constexpr auto reversed(R&& r) noexcept
+{
+  auto const v = view(static_cast<R&&>(r));
+  auto const n = impl::extent_of(v);
+  auto const last = impl::meta_affine(staticmeta<-1>{},
+                                      staticmeta<1>{}, n);
+  return impl::strided_of(v, last, staticmeta<-1>{}, n);
+}
+
+// gather(r, idx) : a view of the elements idx[i] of r
+template <typename R, typename X>
+  requires requires (R&& r, X&& x) {
+    view(static_cast<R&&>(r));
+    { view(static_cast<X&&>(x))[0] }
+                            -> std::convertible_to<std::size_t>;
+  }
+constexpr auto gather(R&& r, X&& idx) noexcept
+{
+  return impl::gather_of(view(static_cast<R&&>(r)),
+                         view(static_cast<X&&>(idx)));
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#undef NUA
+#pragma pop_macro("NUA")
+
+#endif
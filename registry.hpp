@@ -0,0 +1,412 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_REGISTRY_HPP
+#define LML_REGISTRY_HPP
+
+/*
+  registry.hpp
+  ============
+  A registry of static parameters, 'metadynst' staticmeta<(g)> ids of
+  mutable globals, filled in by one pass over a config text at startup,
+  in place of a static constructor per parameter, with ordering issues.
+
+  A parameter opts in by metadata, a key and, optionally, a parser:
+
+  * param_key{"name"} : the config key of the parameter
+  * a parse function, bool(*)(std::string_view, T&), for value type T&;
+    by default parse_param<T>, for bool, arithmetic and enum types
+
+    int batch = 64;
+    double scale = 0.5;
+    using batch_t = staticmeta<(batch), param_key{"batch"}>;
+    using scale_t = staticmeta<(scale), param_key{"scale"}>;
+
+  * registered<P> : a static registration of parameter P, linked into
+                    the registry by a single pointer store
+
+    registered<batch_t> batch_param;
+    registered<scale_t> scale_param;
+
+    The registry is an intrusive list of the registration nodes, headed
+    by a constinit pointer, so there's no allocation; registration is
+    order-independent, valid from any static initializer.
+
+  * load_parameters(config) : sets each registered parameter from its
+                              'key = value' line in config text
+
+    Lines are separated by newlines; blank lines and '#' comments are
+    skipped. One linear scan of the config; each key is matched by a
+    hash index of the registry keys, built once per call, and its value
+    parsed directly into the parameter static, so a load is O(lines +
+    parameters). The index is a static table, of a power of 2 slots,
+    LML_PARAMETA_INDEX_SLOTS, default 1024, so there's no allocation;
+    with more than half as many parameters, keys are matched by a scan
+    of the registry instead. A key registered twice is matched to the last
+    registered.
+    Returns a param_load count of loaded, unknown and invalid lines.
+    Not thread-safe; call it before starting any worker threads.
+
+    load_parameters("batch = 128\nscale = 0.25\n");
+
+  * parameters() -> the first registry node, of key, load and next,
+                    and of the static's data, size and layout hash
+
+  Requires C++20, for class type template arguments as keys.
+*/
+
+#include "parameta.hpp"
+
+#include <charconv>    // from_chars
+#include <cstddef>     // size_t
+#include <cstdint>     // uint64_t, layout hash
+#include <string_view>
+
+#if ! __cpp_concepts
+# error "registry.hpp requires C++20 concepts"
+#endif
+
+#ifndef LML_PARAMETA_INDEX_SLOTS
+#define LML_PARAMETA_INDEX_SLOTS 1024
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+// param_key{"name"} : a config key, as parameter metadata
+template <std::size_t N>
+struct param_key
+{
+  char chars[N];
+  constexpr param_key(char const (&s)[N]) noexcept
+  {
+    for (std::size_t i = 0; i != N; ++i)
+      chars[i] = s[i];
+  }
+  constexpr std::string_view view() const noexcept
+  {
+    return {chars, N - 1};
+  }
+};
+
+// parse_param(s, v) : parse s as a bool, arithmetic or enum value v;
+//                     false, leaving v unchanged, if s isn't all valid
+template <typename T>
+constexpr bool parse_param(std::string_view s, T& v) noexcept
+{
+  if constexpr (std::is_same_v<T, bool>) {
+    if (s == "true" || s == "1")
+      return v = true, true;
+    if (s == "false" || s == "0")
+      return v = false, true;
+    return false;
+  }
+  else if constexpr (std::is_enum_v<T>) {
+    std::underlying_type_t<T> u{};
+    if (! parse_param(s, u))
+      return false;
+    return v = T(u), true;
+  }
+  else {
+    static_assert( std::is_arithmetic_v<T>,
+      "registry parameter needs a parse function for its value type");
+    T t{};
+    auto const e = s.data() + s.size();
+    auto const [p, ec] = std::from_chars(s.data(), e, t);
+    if (ec != std::errc{} || p != e)
+      return false;
+    return v = t, true;
+  }
+}
+
+// param_flat<T> : a T parameter is saved by snapshot.hpp, as bytes;
+//                 trivially copyable and of no pointer type, an address
+//                 being stale in another process. Specialize it false
+//                 for a class that holds pointers
+template <typename T>
+inline constexpr bool param_flat
+  = std::is_trivially_copyable_v<T>
+ && ! std::is_pointer_v<std::remove_all_extents_t<T>>
+ && ! std::is_member_pointer_v<std::remove_all_extents_t<T>>;
+
+// param_node : registry list node of a key and its loader, and of the
+//              static's storage and layout id, for snapshot.hpp, with
+//              null data unless param_flat of the value type
+struct param_node
+{
+  std::string_view key;
+  bool (*load)(std::string_view) noexcept;
+  std::uint64_t layout;
+  void* data;
+  std::size_t size;
+  param_node const* next;
+};
+
+namespace impl {
+
+// fnv1a(s, h) : 64-bit FNV-1a hash of s, continued from h
+constexpr std::uint64_t fnv1a(std::string_view s,
+                   std::uint64_t h = 0xcbf29ce484222325) noexcept
+{
+  for (char c : s)
+    h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+  return h;
+}
+
+// param_layout<T>(key) : a hash of key, and of the size, alignment and
+//                        kind of T, that changes if any of them changes
+template <typename T>
+constexpr std::uint64_t param_layout(std::string_view key) noexcept
+{
+  std::uint64_t const kind
+    = std::is_same_v<T, bool>           << 0
+    | std::is_integral_v<T>             << 1
+    | std::is_signed_v<T>               << 2
+    | std::is_floating_point_v<T>       << 3
+    | std::is_enum_v<T>                 << 4
+    | std::is_class_v<T>                << 5
+    | std::is_pointer_v<T>              << 6
+    | std::is_trivially_copyable_v<T>   << 7;
+  char const bytes[]{char(sizeof(T)), char(sizeof(T) >> 8),
+                     char(alignof(T)), char(kind)};
+  return fnv1a({bytes, sizeof bytes}, fnv1a(key));
+}
+
+inline constinit param_node const* param_head = nullptr;
+
+template <typename X>
+inline constexpr bool is_param_key = false;
+template <std::size_t N>
+inline constexpr bool is_param_key<param_key<N>> = true;
+
+template <typename T>
+using param_parser = bool(*)(std::string_view, T&);
+
+template <typename X>
+inline constexpr std::size_t key_count = is_param_key<X>;
+
+template <typename X, typename T>
+inline constexpr std::size_t parser_count
+             = std::is_convertible_v<X, param_parser<T>>;
+
+// param_meta<T,x...> : the key and the parser from parameter metadata,
+//                      with exactly one key and at most one parser
+template <typename T, decltype(auto)...x>
+struct param_meta
+{
+  static constexpr std::size_t keys
+    = (std::size_t{0} + ... +
+                key_count<std::remove_cvref_t<decltype(x)>>);
+  static constexpr std::size_t parsers
+    = (std::size_t{0} + ... +
+                parser_count<std::remove_cvref_t<decltype(x)>, T>);
+
+  static constexpr std::string_view key() noexcept
+  {
+    std::string_view k;
+    ((k = key_of(x, k)), ...);
+    return k;
+  }
+  static constexpr param_parser<T> parser() noexcept
+  {
+    if constexpr (parsers == 0)
+      return parse_param<T>;
+    else {
+      param_parser<T> p{};
+      ((p = parser_of(x, p)), ...);
+      return p;
+    }
+  }
+ private:
+  template <typename X>
+  static constexpr std::string_view key_of(X const& m,
+                                           std::string_view k) noexcept
+  {
+    if constexpr (is_param_key<X>)
+      return m.view();
+    else
+      return k;
+  }
+  template <typename X>
+  static constexpr param_parser<T> parser_of(X const& f,
+                                             param_parser<T> p) noexcept
+  {
+    if constexpr (parser_count<X, T> != 0)
+      return f;
+    else
+      return p;
+  }
+};
+
+template <typename P> struct param_traits;
+
+template <decltype(auto) v, decltype(auto)...x>
+  requires std::is_lvalue_reference_v<decltype(v)>
+        && (! std::is_const_v<std::remove_reference_t<decltype(v)>>)
+        && (param_meta<std::remove_reference_t<decltype(v)>, x...>
+                                             ::keys == 1)
+        && (param_meta<std::remove_reference_t<decltype(v)>, x...>
+                                             ::parsers <= 1)
+struct param_traits<staticmeta<v,x...>>
+  : param_meta<std::remove_reference_t<decltype(v)>, x...>
+{
+  using value_type = std::remove_reference_t<decltype(v)>;
+
+  static bool load(std::string_view s) noexcept
+  {
+    return param_traits::parser()(s, v);
+  }
+  static constexpr param_node node() noexcept
+  {
+    constexpr bool flat = param_flat<value_type>;
+    return {param_traits::key(), load,
+            param_layout<value_type>(param_traits::key()),
+            flat ? &v : nullptr, flat ? sizeof v : 0, nullptr};
+  }
+};
+
+// param_slots : the static, zero-initialized, slots of param_index, so
+//               an index is built with no allocation
+static_assert( (LML_PARAMETA_INDEX_SLOTS & (LML_PARAMETA_INDEX_SLOTS-1))
+               == 0, "LML_PARAMETA_INDEX_SLOTS must be a power of 2");
+inline constinit param_node const* param_slots[LML_PARAMETA_INDEX_SLOTS]
+                                                                    {};
+
+// param_index : an open addressed hash table of the registry nodes, by
+//               the FNV-1a hash of their keys, for load_parameters, in
+//               param_slots, at most half full, else none, for a scan
+class param_index
+{
+  param_node const** slots = nullptr;
+  std::size_t mask = 0;
+
+ public:
+  param_index() noexcept
+  {
+    std::size_t n = 0;
+    for (param_node const* p = param_head; p; p = p->next)
+      ++n;
+    std::size_t size = 2;
+    while (size < 2 * n)
+      size <<= 1;
+    if (size > LML_PARAMETA_INDEX_SLOTS)
+      return;
+    slots = param_slots;
+    mask = size - 1;
+    for (std::size_t i = 0; i != size; ++i)
+      slots[i] = nullptr;
+    // From the head, so of a key registered twice the last registered
+    for (param_node const* p = param_head; p; p = p->next) {
+      std::size_t i = fnv1a(p->key) & mask;
+      while (slots[i] && slots[i]->key != p->key)
+        i = (i + 1) & mask;
+      if (! slots[i])
+        slots[i] = p;
+    }
+  }
+  param_index(param_index const&) = delete;
+  param_index& operator=(param_index const&) = delete;
+
+  // find(key) : the node of key, or null; by scan with no index
+  param_node const* find(std::string_view key) const noexcept
+  {
+    if (! slots) {
+      param_node const* n = param_head;
+      while (n && n->key != key)
+        n = n->next;
+      return n;
+    }
+    for (std::size_t i = fnv1a(key) & mask; slots[i];
+                     i = (i + 1) & mask)
+      if (slots[i]->key == key)
+        return slots[i];
+    return nullptr;
+  }
+};
+
+constexpr std::string_view trim(std::string_view s) noexcept
+{
+  auto const blank = [](char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+  };
+  while (! s.empty() && blank(s.front()))
+    s.remove_prefix(1);
+  while (! s.empty() && blank(s.back()))
+    s.remove_suffix(1);
+  return s;
+}
+
+} // impl
+
+// registered<P> : a registration, in the registry, of parameter P, a
+//                 staticmeta<(g), param_key{"name"}, parse...> id of a
+//                 mutable global g
+template <typename P>
+  requires requires { impl::param_traits<P>::load; }
+class registered
+{
+  param_node node = impl::param_traits<P>::node();
+ public:
+  registered() noexcept
+  {
+    node.next = impl::param_head;
+    impl::param_head = &node;
+  }
+  registered(registered const&) = delete;
+  registered& operator=(registered const&) = delete;
+};
+
+// parameters() : the head of the registry list, or null if empty
+inline param_node const* parameters() noexcept
+{
+  return impl::param_head;
+}
+
+// param_load : load_parameters counts of config lines
+struct param_load
+{
+  std::size_t loaded;   // parsed into a registered parameter
+  std::size_t unknown;  // of no registered key, or of no '='
+  std::size_t invalid;  // of a registered key not parsed by its parser
+
+  explicit operator bool() const noexcept
+  {
+    return unknown == 0 && invalid == 0;
+  }
+};
+
+// load_parameters(config) : set the registered parameters from config
+//                           lines of 'key = value'
+inline param_load load_parameters(std::string_view config) noexcept
+{
+  param_load r{};
+  impl::param_index const index;
+  while (! config.empty()) {
+    auto const eol = config.find('\n');
+    auto line = impl::trim(config.substr(0, eol));
+    config.remove_prefix(eol == config.npos ? config.size() : eol + 1);
+    if (line.empty() || line.front() == '#')
+      continue;
+    auto const eq = line.find('=');
+    if (eq == line.npos) {
+      ++r.unknown;
+      continue;
+    }
+    auto const key = impl::trim(line.substr(0, eq));
+    auto const value = impl::trim(line.substr(eq + 1));
+    param_node const* const n = index.find(key);
+    if (! n)
+      ++r.unknown;
+    else if (n->load(value))
+      ++r.loaded;
+    else
+      ++r.invalid;
+  }
+  return r;
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
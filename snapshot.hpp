@@ -0,0 +1,295 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_SNAPSHOT_HPP
+#define LML_SNAPSHOT_HPP
+
+/*
+  snapshot.hpp
+  ============
+  Binary snapshot and restore of the registered parameters of
+  "registry.hpp", for warm restarts with exactly the same tuning,
+  instead of re-parsing the config text:
+
+  * save_parameters(buf, n) -> bytes written, or 0 if n is too small
+  * save_parameters(path)   -> true if written to the file at path
+  * snapshot_size()         -> the size of the image, in bytes
+
+  * restore_parameters(image, n) -> snapshot_status
+  * restore_parameters(path)     -> snapshot_status; by mmap, if POSIX
+
+  The image is flat and versioned; a header then, per parameter, its
+  layout hash, its size and its bytes, 8-byte aligned. The header holds
+  a fingerprint of the registered parameter set, of its keys and the
+  size, alignment and kind of the value types, so that an image of a
+  different build, with parameters added, removed or changed, is
+  rejected as stale. Restore is a memcpy per parameter, directly into
+  its static, once the whole image is validated; or none at all.
+
+    if (restore_parameters("tuning.snap") != snapshot_status::ok) {
+      load_parameters(config_text);
+      save_parameters("tuning.snap");
+    }
+
+  Only param_flat parameters are saved, and in the fingerprint; those
+  trivially copyable, and not pointers, whose addresses would be wild
+  in a restarted process. A class holding pointers isn't detected;
+  opt it out by specializing param_flat<T> false.
+  The image is for the same build and platform; it holds raw bytes,
+  in native byte order. Not thread-safe, as load_parameters.
+*/
+
+#include "registry.hpp"
+
+#include <cstdio>  // fopen, fwrite, fread
+#include <cstring> // memcpy, memcmp
+#include <new>     // nothrow, non-POSIX restore buffer
+
+#pragma push_macro("LML_SNAPSHOT_MMAP")
+#undef LML_SNAPSHOT_MMAP
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define LML_SNAPSHOT_MMAP 1
+#else
+# define LML_SNAPSHOT_MMAP 0
+#endif
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+enum class snapshot_status : unsigned char {
+  ok,         // all parameters in the image are restored
+  no_image,   // the file can't be opened or mapped
+  bad_image,  // not a snapshot image, or truncated
+  bad_version,// an image of another snapshot format version
+  stale       // of another parameter set; nothing restored
+};
+
+// snapshot_version : the image format version, in its header
+inline constexpr std::uint32_t snapshot_version = 1;
+
+namespace impl {
+
+struct snapshot_header
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t count;
+  std::uint64_t fingerprint;
+  std::uint64_t bytes;
+};
+
+struct snapshot_entry
+{
+  std::uint64_t layout;
+  std::uint64_t size;
+};
+
+inline constexpr char snapshot_magic[8]
+                          {'l','m','l','p','a','r','a','m'};
+
+constexpr std::size_t pad8(std::size_t n) noexcept
+{
+  return (n + 7) / 8 * 8;
+}
+
+// mix(h) : a 64-bit finalizer, so that summed layouts don't cancel
+constexpr std::uint64_t mix(std::uint64_t h) noexcept
+{
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+  return h ^ (h >> 31);
+}
+
+// snapshot_set : the count, fingerprint and image size of the saved,
+//                param_flat, registered parameters; the fingerprint
+//                is independent of registration order
+struct snapshot_set
+{
+  std::uint32_t count = 0;
+  std::uint64_t fingerprint = 0;
+  std::size_t bytes = sizeof(snapshot_header);
+};
+
+inline snapshot_set snapshot_params() noexcept
+{
+  snapshot_set s;
+  for (param_node const* n = parameters(); n; n = n->next)
+    if (n->data) {
+      ++s.count;
+      s.fingerprint += mix(n->layout);
+      s.bytes += sizeof(snapshot_entry) + pad8(n->size);
+    }
+  s.fingerprint = mix(s.fingerprint ^ s.count);
+  return s;
+}
+
+// find_param(layout, hint) : the node of the layout hash, trying the
+//                  hint first, as images are saved in registry order
+inline param_node const* find_param(std::uint64_t layout,
+                                    param_node const* hint) noexcept
+{
+  if (hint && hint->data && hint->layout == layout)
+    return hint;
+  for (param_node const* n = parameters(); n; n = n->next)
+    if (n->data && n->layout == layout)
+      return n;
+  return nullptr;
+}
+
+// write_image(set, put) : the image of set, through put(bytes, size),
+//                         part by part; false if any put fails
+template <typename Put>
+bool write_image(snapshot_set const& set, Put put) noexcept
+{
+  snapshot_header h{{}, snapshot_version, set.count,
+                    set.fingerprint, set.bytes};
+  std::memcpy(h.magic, snapshot_magic, sizeof h.magic);
+  if (! put(&h, sizeof h))
+    return false;
+  unsigned char const zeros[8]{};
+  for (param_node const* p = parameters(); p; p = p->next)
+    if (p->data) {
+      snapshot_entry const e{p->layout, p->size};
+      if (! put(&e, sizeof e) || ! put(p->data, p->size)
+       || ! put(zeros, pad8(p->size) - p->size))
+        return false;
+    }
+  return true;
+}
+
+} // impl
+
+// snapshot_size() : bytes in an image of the registered parameters
+inline std::size_t snapshot_size() noexcept
+{
+  return impl::snapshot_params().bytes;
+}
+
+// save_parameters(buf, n) : write the image to buf, of n bytes;
+//                           the image size, or 0 if n is too small
+inline std::size_t save_parameters(void* buf, std::size_t n) noexcept
+{
+  auto const set = impl::snapshot_params();
+  if (n < set.bytes)
+    return 0;
+  auto* out = static_cast<unsigned char*>(buf);
+  impl::write_image(set, [&out](void const* p, std::size_t k) {
+    std::memcpy(out, p, k);
+    out += k;
+    return true;
+  });
+  return set.bytes;
+}
+
+// save_parameters(path) : write the image to the file at path
+inline bool save_parameters(char const* path) noexcept
+{
+  std::FILE* f = std::fopen(path, "wb");
+  if (! f)
+    return false;
+  bool const ok = impl::write_image(impl::snapshot_params(),
+    [f](void const* p, std::size_t k) {
+      return std::fwrite(p, 1, k, f) == k;
+    });
+  return std::fclose(f) == 0 && ok;
+}
+
+// restore_parameters(image, n) : validate the n byte image, then copy
+//                                each of its parameters to its static
+inline snapshot_status restore_parameters(void const* image,
+                                          std::size_t n) noexcept
+{
+  auto const* in = static_cast<unsigned char const*>(image);
+  impl::snapshot_header h;
+  if (n < sizeof h)
+    return snapshot_status::bad_image;
+  std::memcpy(&h, in, sizeof h);
+  if (std::memcmp(h.magic, impl::snapshot_magic, sizeof h.magic) != 0)
+    return snapshot_status::bad_image;
+  if (h.version != snapshot_version)
+    return snapshot_status::bad_version;
+  if (h.bytes != n)
+    return snapshot_status::bad_image;
+  auto const set = impl::snapshot_params();
+  if (h.fingerprint != set.fingerprint || h.count != set.count
+   || h.bytes != set.bytes)
+    return snapshot_status::stale;
+
+  // Validate all the entries before copying any, so that a restore is
+  // all or nothing
+  for (int copy = 0; copy != 2; ++copy) {
+    std::size_t at = sizeof h;
+    param_node const* hint = parameters();
+    for (std::uint32_t i = 0; i != h.count; ++i) {
+      impl::snapshot_entry e;
+      if (n - at < sizeof e)
+        return snapshot_status::bad_image;
+      std::memcpy(&e, in + at, sizeof e);
+      at += sizeof e;
+      param_node const* p = impl::find_param(e.layout, hint);
+      if (! p || p->size != e.size)
+        return snapshot_status::stale;
+      if (n - at < impl::pad8(p->size))
+        return snapshot_status::bad_image;
+      if (copy)
+        std::memcpy(p->data, in + at, p->size);
+      at += impl::pad8(p->size);
+      hint = p->next;
+    }
+  }
+  return snapshot_status::ok;
+}
+
+// restore_parameters(path) : restore from the image file at path
+inline snapshot_status restore_parameters(char const* path) noexcept
+{
+#if LML_SNAPSHOT_MMAP
+  int const fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+    return snapshot_status::no_image;
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return snapshot_status::no_image;
+  }
+  if (st.st_size < std::ptrdiff_t(sizeof(impl::snapshot_header))) {
+    ::close(fd);
+    return snapshot_status::bad_image;
+  }
+  std::size_t const n = static_cast<std::size_t>(st.st_size);
+  void* const image = ::mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (image == MAP_FAILED)
+    return snapshot_status::no_image;
+  snapshot_status const s = restore_parameters(
+                              static_cast<void const*>(image), n);
+  ::munmap(image, n);
+  return s;
+#else
+  std::FILE* f = std::fopen(path, "rb");
+  if (! f)
+    return snapshot_status::no_image;
+  std::size_t const n = snapshot_size();
+  unsigned char* buf = new (std::nothrow) unsigned char[n + 1];
+  std::size_t const got = buf ? std::fread(buf, 1, n + 1, f) : 0;
+  std::fclose(f);
+  snapshot_status const s = buf ? restore_parameters(
+                                    static_cast<void const*>(buf), got)
+                                : snapshot_status::no_image;
+  delete[] buf;
+  return s;
+#endif
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#undef LML_SNAPSHOT_MMAP
+#pragma pop_macro("LML_SNAPSHOT_MMAP")
+
+#endif
@@ -0,0 +1,288 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_STORAGE_HPP
+#define LML_STORAGE_HPP
+
+/*
+  storage.hpp
+  ===========
+  Storage policies for ray, chosen by the staticity of its Extent, in
+  place of a heap allocation per object, as for unique_ptr<T[]>:
+
+  * ray_storage_t<T,E> : the Storage type for T elements, of Extent E
+
+      metaconst E, N*sizeof(T) <= Limit   T[N], in-class, no allocation
+      metastatic E                        pooled<T,E>, a block of the
+                                          shared pool of E::value T's
+      dynamic E                           T*, from an arena
+
+    Limit, the inline threshold in bytes, defaults to 256. A larger
+    metaconst extent is metastatic, so is pooled.
+
+  * make_ray<T,E>()      -> a ray<ray_storage_t<T,E>,E>, of static E
+  * make_ray<T>(a, n)    -> a ray<T*, dynameta<size_t>> of n T's from
+                            arena a, or of null data() if a is full
+
+  * pooled<T,E> : an owning block of E::value value-initialized T's,
+                  from the pool of blocks of that size, shared by all
+                  pooled<T,E> objects, and released to it on destruction
+
+    Blocks are reused, so after warm-up there's no allocation. The block
+    size is read from the static E::value, and blocks of an older size
+    are freed, not reused, if it changes; change it only while no ray
+    of it exists. Acquire and release are by a short spin lock; the free
+    list is not freed at exit, but stays reachable.
+
+  * arena : a bump allocator over a buffer, for per-request allocations
+            all freed at once by reset(), with no per-object bookkeeping
+
+      arena_buffer<1 << 16> scratch;   // an arena of in-class storage
+      auto r = make_ray<float>(scratch, n);
+      ...
+      scratch.reset();                 // at the end of each request
+
+    Only for trivially destructible T; no destructors are run on reset.
+    Allocations are aligned by address, for any buffer alignment and
+    over-aligned T, padding as needed.
+    An exhausted arena returns null, not an exception.
+
+  Requires C++20 concepts.
+*/
+
+#include "ray.hpp"
+
+#include <atomic>
+#include <cstddef> // max_align_t
+#include <cstdint> // uintptr_t
+#include <memory>  // uninitialized_value_construct_n, destroy_n
+#include <new>     // operator new, align_val_t, launder
+#include <thread>  // yield
+#include <utility> // swap
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+/* arena  ********************************************************** */
+
+class arena
+{
+  unsigned char* base_;
+  std::size_t capacity_;
+  std::size_t top_ = 0;
+
+ public:
+  constexpr arena(void* buf, std::size_t bytes) noexcept
+    : base_{static_cast<unsigned char*>(buf)}, capacity_{bytes} {}
+  arena(arena const&) = delete;
+  arena& operator=(arena const&) = delete;
+
+  // allocate<T>(n) : n value-initialized T's, or null if out of room
+  template <typename T>
+  T* allocate(std::size_t n) noexcept
+  {
+    static_assert( std::is_trivially_destructible_v<T>,
+                "arena storage is reset without running destructors");
+    // Align the address, not the offset; a buffer may be misaligned
+    auto const top = reinterpret_cast<std::uintptr_t>(base_ + top_);
+    std::size_t const pad = (alignof(T) - top % alignof(T))
+                                         % alignof(T);
+    if (pad > capacity_ - top_
+     || n > (capacity_ - top_ - pad) / sizeof(T))
+      return nullptr;
+    std::size_t const at = top_ + pad;
+    top_ = at + n * sizeof(T);
+    auto* const p = reinterpret_cast<T*>(base_ + at);
+    std::uninitialized_value_construct_n(p, n);
+    return std::launder(p);
+  }
+
+  // reset() : free all allocations at once
+  void reset() noexcept { top_ = 0; }
+
+  std::size_t used() const noexcept { return top_; }
+  std::size_t capacity() const noexcept { return capacity_; }
+};
+
+// arena_buffer<Bytes> : an arena of in-class storage
+template <std::size_t Bytes>
+class arena_buffer : public arena
+{
+  alignas(std::max_align_t) unsigned char buf_[Bytes];
+ public:
+  arena_buffer() noexcept : arena{buf_, Bytes} {}
+};
+
+/* pooled  ********************************************************* */
+
+namespace impl {
+
+// block_pool<T> : the free list of blocks of T's, of one size at a time
+template <typename T>
+struct block_pool
+{
+  struct header
+  {
+    header* next;
+    std::size_t size;
+  };
+
+  // Element storage follows the header, aligned for T
+  static constexpr std::size_t offset
+      = (sizeof(header) + alignof(T) - 1) / alignof(T) * alignof(T);
+  static constexpr std::size_t align
+      = alignof(T) > alignof(header) ? alignof(T) : alignof(header);
+
+  std::atomic<bool> busy{false};
+  header* free = nullptr;
+
+  void lock() noexcept
+  {
+    while (busy.exchange(true, std::memory_order_acquire))
+      std::this_thread::yield();
+  }
+  void unlock() noexcept
+  {
+    busy.store(false, std::memory_order_release);
+  }
+
+  static T* elements(header* h) noexcept
+  {
+    return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(h)
+                                + offset);
+  }
+  static header* header_of(T* p) noexcept
+  {
+    return reinterpret_cast<header*>(reinterpret_cast<unsigned char*>(p)
+                                     - offset);
+  }
+
+  // acquire(n) : a free block of n elements, or a new one
+  T* acquire(std::size_t n)
+  {
+    header* h = nullptr;
+    lock();
+    if (free && free->size == n) {
+      h = free;
+      free = h->next;
+    }
+    unlock();
+    if (! h) {
+      h = static_cast<header*>(::operator new(offset + n * sizeof(T),
+                                              std::align_val_t{align}));
+      h->size = n;
+    }
+    T* const p = elements(h);
+    std::uninitialized_value_construct_n(p, n);
+    return std::launder(p);
+  }
+
+  // release(p, n) : return the block to the free list, if of size n,
+  //                 else free it, and any free blocks of another size
+  void release(T* p, std::size_t n) noexcept
+  {
+    header* const h = header_of(p);
+    std::destroy_n(p, h->size);
+    header* stale = nullptr;
+    lock();
+    if (h->size == n) {
+      if (free && free->size != n) {
+        stale = free;
+        free = nullptr;
+      }
+      h->next = free;
+      free = h;
+    }
+    else {
+      h->next = nullptr;
+      stale = h;
+    }
+    unlock();
+    while (stale) {
+      header* const next = stale->next;
+      ::operator delete(stale, std::align_val_t{align});
+      stale = next;
+    }
+  }
+};
+
+template <typename T, typename E>
+inline constinit block_pool<T> pool_of{};
+
+} // impl
+
+template <typename T, metastatic E>
+  requires std::is_integral_v<
+                 std::remove_cvref_t<typename E::value_type>>
+class pooled
+{
+  T* p_;
+
+  static std::size_t blocksize() noexcept
+  {
+    return static_cast<std::size_t>(E::value);
+  }
+ public:
+  pooled() : p_{impl::pool_of<T,E>.acquire(blocksize())} {}
+  pooled(pooled&& o) noexcept : p_{o.p_} { o.p_ = nullptr; }
+  pooled& operator=(pooled&& o) noexcept
+  {
+    std::swap(p_, o.p_);
+    return *this;
+  }
+  ~pooled()
+  {
+    if (p_)
+      impl::pool_of<T,E>.release(p_, blocksize());
+  }
+
+  T* get() const noexcept { return p_; }
+  T& operator[](std::size_t i) const noexcept { return p_[i]; }
+};
+
+/* Selection  ****************************************************** */
+
+namespace impl {
+
+template <typename T, typename E, std::size_t Limit>
+constexpr auto select_storage() noexcept
+{
+  if constexpr (metaconst<E>) {
+    if constexpr (E::value * sizeof(T) <= Limit && E::value > 0)
+      return std::type_identity<T[E::value]>{};
+    else
+      return std::type_identity<pooled<T,E>>{};
+  }
+  else if constexpr (metastatic<E>)
+    return std::type_identity<pooled<T,E>>{};
+  else
+    return std::type_identity<T*>{};
+}
+
+} // impl
+
+// ray_storage_t<T,E,Limit> : the Storage of T elements for Extent E
+template <typename T, metavalue E, std::size_t Limit = 256>
+using ray_storage_t
+      = typename decltype(impl::select_storage<T,E,Limit>())::type;
+
+// make_ray<T,E>() : a ray of T, of in-class or pooled storage
+template <typename T, metastatic E, std::size_t Limit = 256>
+auto make_ray()
+{
+  return ray<ray_storage_t<T,E,Limit>, E>{};
+}
+
+// make_ray<T>(a, n) : a ray of n T's in arena a; null data() if full
+template <typename T>
+auto make_ray(arena& a, std::size_t n) noexcept
+{
+  T* const p = a.allocate<T>(n);
+  return ray<T*, dynameta<std::size_t>>{p, {p ? n : 0}};
+}
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif
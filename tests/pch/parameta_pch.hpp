@@ -0,0 +1,14 @@
+// A shared precompiled header, of the library headers only, as built by
+// meson's cpp_pch for test_pch.cpp; usable as a plain header otherwise
+#ifndef LML_TEST_PARAMETA_PCH_HPP
+#define LML_TEST_PARAMETA_PCH_HPP
+
+#include "parameta.hpp"
+#include "dispatch_static.hpp"
+#include "tunable.hpp"
+#if __cpp_concepts
+#include "mdray.hpp"
+#include "number_kernels.hpp"
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+#include "anymeta.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+int g = 4;
+int h = 4;
+constexpr int k = 16;
+
+// anymeta is a dynamic metavalue, trivially copyable, with no heap
+static_assert( is_metavalue_v<anymeta<int>>
+           && ! is_metastatic_v<anymeta<int>> );
+static_assert( std::is_trivially_copyable_v<anymeta<long>> );
+static_assert( sizeof(anymeta<int>) == 2 * sizeof(int*) );
+static_assert( sizeof(anymeta<char>) == 2 * sizeof(int*) );
+static_assert( SAME<anymeta<int>::value_type, int> );
+
+// The kind of each source metavalue
+constexpr anymeta<int> c8 = staticmeta<8>{};
+constexpr anymeta<int> cr = staticmeta<(k)>{};  // constexpr by ref
+constexpr anymeta<int> sg = staticmeta<(g)>{};
+constexpr anymeta<int> d2 = dynameta<int>{2};
+constexpr anymeta<long> cl = staticmeta<'a'>{}; // converts to long
+
+static_assert( c8.kind() == anymeta_kind::constant && c8() == 8 );
+static_assert( cr.kind() == anymeta_kind::constant && cr == 16 );
+static_assert( sg.kind() == anymeta_kind::indirect
+            && sg.address() == &g );
+static_assert( d2.kind() == anymeta_kind::dynamic && d2() == 2 );
+static_assert( cl() == 97L && c8.address() == nullptr );
+static_assert( anymeta<int>{}() == 0
+            && anymeta<int>{}.kind() == anymeta_kind::dynamic );
+
+// A static of another value type is copied, dynamic, not pointed to
+short sh = 5;
+anymeta<int> const ss = staticmeta<(sh)>{};
+
+// Copy keeps the kind, and an anymeta source isn't re-wrapped
+constexpr anymeta<int> sg2 = sg;
+static_assert( sg2.address() == &g );
+
+// The kernel tells, by its return, which staticity it was called with
+struct kernel {
+  template <typename N>
+  constexpr int operator()(N n) const {
+    if constexpr (is_metaconst_v<N>)
+      return 100 + N::value;
+    else if constexpr (is_metastatic_v<N>)
+      return &N::value == &g ? 200 : 300;
+    else
+      return n();
+  }
+};
+
+using candidates = staticmeta<2,8,(g)>;
+
+static_assert( dispatch_static<candidates>(c8, kernel{}) == 108 );
+static_assert( dispatch_static<candidates>(d2, kernel{}) == 102 );
+static_assert( dispatch_static<candidates>(cr, kernel{}) == 16 );
+static_assert( dispatch_static<staticmeta<16>>(cr, kernel{}) == 116 );
+
+int main()
+{
+  int fails = 0;
+
+  // A converted static is a snapshot, as dynamic, with no address
+  fails += ss.kind() != anymeta_kind::dynamic || ss() != 5
+        || ss.address() != nullptr;
+
+  // Indirect reads see writes to the static
+  anymeta<int> a = staticmeta<(g)>{};
+  g = 7;
+  fails += a() != 7 || int(a) != 7;
+
+  // dispatch recovers the static by address, not by value
+  fails += dispatch_static<candidates>(a, kernel{}) != 200;
+  h = 7;
+  anymeta<int> b = staticmeta<(h)>{};
+  fails += dispatch_static<candidates>(b, kernel{}) != 7;
+
+  // An indirect value is never matched to a constant candidate
+  g = 8;
+  fails += dispatch_static<staticmeta<8>>(a, kernel{}) != 8;
+
+  // Runtime values match constant candidates
+  volatile int v = 2;
+  anymeta<int> r = dynameta<int>{v};
+  fails += dispatch_static<candidates>(r, kernel{}) != 102;
+
+  return fails;
+}
@@ -0,0 +1,143 @@
+#if __cpp_impl_coroutine && __cpp_concepts
+#include "async_load.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace NAMESPACE_ID;
+
+// An async_param id is a zero-size metastatic parameter
+async_param<int> batch{64};
+async_param<double> scale{0.5};
+using batch_t = staticmeta<(batch)>;
+static_assert( is_metastatic_v<batch_t> && std::is_empty_v<batch_t> );
+static_assert( async_param<int>::load_order == std::memory_order_acquire
+     && async_param<int, std::memory_order_relaxed>::load_order
+                                    == std::memory_order_relaxed );
+
+tunable<int> spin{100};
+
+struct config { dynameta<int> threads{1}; dynameta<bool> verbose{}; };
+config cfg;
+
+int one_gen() { return 1; }
+
+// A fake config service; requests complete later, on another thread
+struct service
+{
+  std::map<std::string, std::string, std::less<>> data;
+  std::mutex m;
+  std::vector<std::thread> replies;
+  int round_trips = 0;
+
+  void fetch(std::span<std::string_view const> keys, batch_done done)
+  {
+    std::lock_guard lock(m);
+    ++round_trips;
+    std::vector<std::string_view> k(keys.begin(), keys.end());
+    replies.emplace_back([this, k, done] {
+      std::vector<std::optional<std::string_view>> v;
+      for (auto key : k) {
+        auto i = data.find(key);
+        v.push_back(i == data.end() ? std::nullopt
+                    : std::optional<std::string_view>{i->second});
+      }
+      done(v);
+    });
+  }
+  void join()
+  {
+    for (auto& t : replies)
+      t.join();
+  }
+};
+
+// A minimal fire-and-forget coroutine type, for the test
+struct detached
+{
+  struct promise_type
+  {
+    detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept {}
+  };
+};
+
+std::atomic<int> done_batches{0};
+param_load first_load{}, second_load{};
+
+detached load_first(param_batch const& b, service& s)
+{
+  first_load = co_await load_async(b, [&s](auto keys, batch_done d) {
+    s.fetch(keys, d);
+  });
+  ++done_batches;
+}
+detached load_second(param_batch const& b, service& s)
+{
+  second_load = co_await load_async(b, [&s](auto keys, batch_done d) {
+    s.fetch(keys, d);
+  });
+  ++done_batches;
+}
+
+int main()
+{
+  int fails = 0;
+
+  service s;
+  s.data = {{"batch", "256"}, {"scale", "0.125"}, {"spin", "x"},
+            {"threads", "8"}, {"verbose", "true"}};
+
+  param_batch one, two;
+  one.add("batch", batch).add("scale", scale).add("spin", spin);
+  two.add("threads", cfg.threads).add("verbose", cfg.verbose)
+     .add("missing", spin);
+
+  // Defaults are read until the overrides are in
+  fails += batch_t{}() != 64 || batch.ready();
+
+  load_first(one, s);
+  load_second(two, s);
+  s.join();
+
+  fails += done_batches != 2 || s.round_trips != 2;
+  fails += batch() != 256 || ! batch.ready() || scale != 0.125;
+  fails += spin != 100;                       // invalid, unchanged
+  fails += cfg.threads() != 8 || ! cfg.verbose();
+  fails += first_load.loaded != 2 || first_load.invalid != 1;
+  fails += second_load.loaded != 2 || second_load.unknown != 1;
+
+  // A fetch may complete inline, before the await_suspend returns;
+  // the coroutine goes straight on, while the fetch reads its state
+  async_param<int> now{0};
+  lazymeta<one_gen> lazy, computed;
+  fails += computed() != 1;
+  param_batch three;
+  three.add("now", now).add("lazy", lazy).add("computed", computed);
+  bool resumed = false;
+  std::size_t tail = 0;
+  [&](param_batch const& b) -> detached {
+    auto inline_fetch = [&, tag = std::string(32, 't')]
+                        (auto, batch_done d) {
+      std::optional<std::string_view> v[]{"7", "9", "9"};
+      d(v);
+      fails += resumed;                 // suspend is yet to return
+      tail = tag.size();                // the fetch is still alive
+    };
+    co_await load_async(b, inline_fetch);
+    resumed = true;
+  }(three);
+  fails += now() != 7 || ! resumed || tail != 32;
+  fails += ! lazy.ready() || lazy() != 9 || computed() != 1;
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,84 @@
+#include "autotune.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+using tiles_t = autotuned<staticmeta<16,32,64,128>, staticmeta<1,2,4>>;
+
+static_assert( tiles_t::size() == 12 );
+
+// Variants are row-major, the last candidate list fastest
+static_assert( impl::stride<0, staticmeta<16,32,64,128>,
+                               staticmeta<1,2,4>>() == 3 );
+static_assert( impl::stride<1, staticmeta<16,32,64,128>,
+                               staticmeta<1,2,4>>() == 1 );
+
+// The kernel gets a metaconst per parameter; it returns a simulated
+// cost that is least for tile 64, unroll 2
+struct kernel {
+  template <typename T, typename U>
+  int operator()(T, U) const {
+    static_assert( is_metaconst_v<T> && is_metaconst_v<U> );
+    constexpr int t = T::value, u = U::value;
+    return (t > 64 ? t - 64 : 64 - t) + (u > 2 ? u - 2 : 2 - u);
+  }
+};
+
+// A cost measure of the run's result, deterministic for the test
+struct simulated {
+  template <typename Run>
+  double operator()(Run& run) const { return run(); }
+};
+
+tiles_t tiles;
+
+// The tuned static's id is a zero-size metastatic parameter
+static_assert( is_metastatic_v<staticmeta<(tiles)>> );
+
+int main()
+{
+  int fails = 0;
+
+  // Before tuning, the first candidates
+  fails += tiles.choice() != 0;
+  fails += tiles.chosen<0>() != 16 || tiles.chosen<1>() != 1;
+  fails += tiles(kernel{}) != 48 + 1;
+
+  // tune times every variant and chooses the best
+  fails += tiles.tune(kernel{}, simulated{}) != 2 * 3 + 1;
+  fails += tiles.chosen<0>() != 64 || tiles.chosen<1>() != 2;
+  fails += tiles(kernel{}) != 0;
+
+  // Calls of the chosen variant see its candidates as metaconst
+  fails += tiles([](auto t, auto u) { return t() * 10 + u(); }) != 642;
+
+  // An offline choice, and out-of-range selections rejected
+  fails += ! tiles.select(11) || tiles.chosen<0>() != 128
+        || tiles.chosen<1>() != 4;
+  fails += tiles.select(12) || tiles.choice() != 11;
+
+  // Timed tuning, by default best of 5, chooses a valid variant
+  autotuned<staticmeta<1,2>> timed;
+  std::size_t const won = timed.tune([](auto n) {
+    volatile int s = 0;
+    for (int i = 0; i != 1000 * n(); ++i)
+      s = s + i;
+    return n();
+  });
+  fails += won >= timed.size() || timed.choice() != won;
+
+  // Pure variants are timed, their results kept, and void ones too
+  autotuned<staticmeta<10,1000>> pure;
+  auto sum = [](auto n) {
+    unsigned s = 0;
+    for (unsigned i = 0; i != n(); ++i)
+      s += i * i;
+    return s;
+  };
+  fails += pure.tune(sum) >= pure.size()
+        || pure(sum) != (pure.chosen<0>() == 10 ? 285u : 332833500u);
+  fails += pure.tune([](auto) {}) >= pure.size();
+
+  return fails;
+}
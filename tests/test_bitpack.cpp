@@ -0,0 +1,93 @@
+#if __cpp_concepts
+#include "bitpack.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+int g = 3;
+
+enum class mode : unsigned char { off, on, auto_, test };
+
+// 3 + 5 + 1 bits, metaconst and metastatic taking none, in a uint16_t
+using header = bitpack<dynameta<unsigned, bits<3>>, staticmeta<64>,
+                       dynameta<unsigned, bits<5>>, staticmeta<(g)>,
+                       dynameta<bool>>;
+static_assert( sizeof(header) == 2 );
+static_assert( header::size() == 5 && header::dynamic() == 3 );
+
+constexpr header h{5u, 17u, true};
+static_assert( get<0>(h)() == 5 && get<2>(h)() == 17 && get<4>(h)() );
+static_assert( SAME<decltype(get<0>(h)), dynameta<unsigned, bits<3>>> );
+static_assert( SAME<decltype(get<1>(h)), staticmeta<64>> );
+static_assert( is_metastatic_v<decltype(get<3>(h))> );
+
+// As separate members: 4 bytes each, 12 bytes, against 2
+static_assert( sizeof(metastruct<dynameta<unsigned>, staticmeta<64>,
+                                 dynameta<unsigned>, staticmeta<(g)>,
+                                 dynameta<bool>>) == 12 );
+
+// Signed fields sign-extend; enums are stored by underlying value
+constexpr auto signs = [] {
+  bitpack<dynameta<int, bits<4>>, dynameta<mode, bits<2>>,
+          dynameta<short, bits<10>>> p{-8, mode::test, -300};
+  return std::array{get<0>(p)(), int(get<1>(p)()), int(get<2>(p)())};
+}();
+static_assert( signs[0] == -8 && signs[1] == 3 && signs[2] == -300 );
+
+// Values are truncated to the field width, and other fields kept
+constexpr auto truncated = [] {
+  header p{0u, 31u, false};
+  set<0>(p, 9u);                     // 9 & 7
+  return std::array{get<0>(p)(), get<2>(p)()};
+}();
+static_assert( truncated[0] == 1 && truncated[1] == 31 );
+
+// Over 64 bits, fields are placed in 64-bit words, not straddling
+using wide = bitpack<dynameta<std::uint64_t, bits<40>>,
+                     dynameta<std::uint64_t, bits<40>>,
+                     dynameta<unsigned, bits<24>>>;
+static_assert( sizeof(wide) == 16 );
+static_assert( wide::layout::places[1].word == 1
+            && wide::layout::places[2].shift == 40 );
+
+// All static: an empty pack
+using none = bitpack<staticmeta<1>, staticmeta<(g)>>;
+static_assert( std::is_empty_v<none> && none::dynamic() == 0 );
+
+// Only integral and enum fields pack, within their width
+template <typename...P>
+concept packs = requires { typename bitpack<P...>; };
+static_assert( ! packs<dynameta<double>> );
+static_assert( ! packs<dynameta<int&, bits<3>>> );
+
+// Tag access through typemeta metadata
+struct width; struct flags;
+using tagged = bitpack<dynameta<unsigned, bits<6>, typemeta<width>{}>,
+                       dynameta<unsigned, typemeta<flags>{}, bits<2>>>;
+static_assert( sizeof(tagged) == 1 );
+
+int main()
+{
+  int fails = 0;
+
+  tagged t{40u, 2u};
+  fails += get<width>(t)() != 40 || get<flags>(t)() != 2;
+  set<width>(t, 63u);
+  set<flags>(t, 1u);
+  fails += get<width>(t)() != 63 || get<flags>(t)() != 1;
+
+  wide w{(std::uint64_t{1} << 40) - 1, 12345u, 0xabcdefu};
+  fails += get<0>(w)() != (std::uint64_t{1} << 40) - 1;
+  fails += get<1>(w)() != 12345u || get<2>(w)() != 0xabcdefu;
+
+  header h2{};
+  set<4>(h2, true);
+  fails += get<0>(h2)() != 0 || ! get<4>(h2)();
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,109 @@
+#include "dispatch_static.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+using candidates = staticmeta<2,4,8>;
+
+// The kernel tells, by its return, which staticity it was called with
+struct kernel {
+  template <typename N>
+  constexpr int operator()(N n) const {
+    if constexpr (is_metaconst_v<N>)
+      return 100 + N::value;
+    else
+      return n();
+  }
+};
+
+static_assert( dispatch_static<candidates>(dynameta<int>{2}, kernel{})
+               == 102 );
+static_assert( dispatch_static<candidates>(dynameta<int>{8}, kernel{})
+               == 108 );
+static_assert( dispatch_static<candidates>(dynameta<int>{5}, kernel{})
+               == 5 );
+static_assert( dispatch_static<staticmeta<7>>(dynameta<int>{7}, kernel{})
+               == 107 );
+
+// A metaconst argument is passed straight through, with no dispatch
+static_assert( dispatch_static<candidates>(staticmeta<5>{}, kernel{})
+               == 105 );
+
+// Candidate and argument value types need only compare equal
+static_assert( dispatch_static<staticmeta<'a',2L>>(dynameta<long>{97},
+               kernel{}) == 197 );
+
+// The result is converted to the return type of the fallback call f(d)
+constexpr auto fallback_type = [](auto n) {
+  if constexpr (is_metaconst_v<decltype(n)>) return short{1};
+  else return long{n};
+};
+static_assert( SAME<decltype(dispatch_static<candidates>(
+                      dynameta<int>{2}, fallback_type)), long> );
+
+// Distinct integral candidates of the argument type index a table
+// of calls, by offset for a small span, in any order, or else by binary
+// search; the plans are those of metatable.hpp, with no hashing
+using dense = staticmeta<3,1,2,0>;
+using sparse = staticmeta<5000,1,1000,100>;
+
+static_assert( impl::unhashed_plan_of<impl::meta_array<3,1,2,0>>.lookup
+               == metatable_lookup::direct );
+static_assert( impl::unhashed_plan_of<impl::meta_array<5000,1,1000,100>>
+               .lookup == metatable_lookup::sorted );
+
+template <typename L>
+constexpr int dispatched(int v) {
+  return dispatch_static<L>(dynameta<int>{v}, kernel{});
+}
+
+static_assert( dispatched<dense>(0) == 100 && dispatched<dense>(3) == 103
+            && dispatched<dense>(4) == 4 && dispatched<dense>(-1) == -1 );
+
+static_assert( dispatched<sparse>(1) == 101
+            && dispatched<sparse>(5000) == 5100
+            && dispatched<sparse>(1000) == 1100
+            && dispatched<sparse>(999) == 999
+            && dispatched<sparse>(6000) == 6000 );
+
+// Repeated candidates are compared in order; the first match is called
+struct first {
+  template <typename N>
+  constexpr int operator()(N) const { return is_metaconst_v<N>; }
+};
+static_assert( dispatch_static<staticmeta<2,2,2>>(dynameta<int>{2},
+               first{}) == 1 );
+
+int global;
+
+int main()
+{
+  // Void kernels, runtime dispatch, and a by-reference dynameta value
+  int which = 0;
+  auto record = [&](auto n) {
+    which = is_metaconst_v<decltype(n)> ? 100 + n() : -n();
+  };
+  dynameta<int&> extent{global};
+
+  global = 4;
+  dispatch_static<candidates>(extent, record);
+  if (which != 104) return 1;
+
+  global = 3;
+  dispatch_static<candidates>(extent, record);
+  if (which != -3) return 1;
+
+  // Runtime table dispatch, dense and sparse
+  for (int i = -2; i != 6; ++i) {
+    global = i;
+    dispatch_static<dense>(extent, record);
+    if (which != (i >= 0 && i <= 3 ? 100 + i : -i)) return 1;
+  }
+  for (int i : {1, 100, 1000, 5000, 0, 99, 5001}) {
+    global = i;
+    dispatch_static<sparse>(extent, record);
+    bool const hit = i == 1 || i == 100 || i == 1000 || i == 5000;
+    if (which != (hit ? 100 + i : -i)) return 1;
+  }
+}
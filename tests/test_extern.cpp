@@ -0,0 +1,67 @@
+#ifndef LML_PARAMETA_EXTERN
+#define LML_PARAMETA_EXTERN
+#endif
+
+#include "parameta.hpp"
+
+using namespace NAMESPACE_ID;
+
+// The precomputed classification agrees with the computed one, for
+// types in the precomputed set and for types out of its range
+
+constexpr int out = LML_PARAMETA_PRECOMPUTED_MAX + 1;
+
+template <typename Q>
+constexpr bool precomputed = std::is_base_of_v<impl::const_value_kind,
+                                               impl::meta_kind<Q>>
+                          || std::is_base_of_v<impl::dynamic_value_kind,
+                                               impl::meta_kind<Q>>;
+
+template <typename A, typename B>
+constexpr bool same_kind = is_metavalue_v<A> == is_metavalue_v<B>
+                        && is_metastatic_v<A> == is_metastatic_v<B>
+                        && is_metaconst_v<A> == is_metaconst_v<B>
+                        && is_metatype_v<A> == is_metatype_v<B>
+                        && is_metapara_v<A> == is_metapara_v<B>;
+
+static_assert( precomputed<dynameta<int>> );
+static_assert( precomputed<dynameta<double>> );
+static_assert( ! precomputed<dynameta<int, 1>> );
+static_assert( ! precomputed<dynameta<long double>> );
+
+static_assert( same_kind<dynameta<int>, dynameta<int, 1>> );
+static_assert( same_kind<dynameta<bool>, dynameta<bool, 1>> );
+static_assert( is_metavalue_v<dynameta<int>>
+           && ! is_metastatic_v<dynameta<int>> );
+
+#if __cpp_concepts
+static_assert( precomputed<staticmeta<0>> );
+static_assert( precomputed<staticmeta<LML_PARAMETA_PRECOMPUTED_MAX>> );
+static_assert( precomputed<staticmeta<std::size_t{3}>> );
+static_assert( ! precomputed<staticmeta<out>> );
+static_assert( ! precomputed<staticmeta<-1>> );
+static_assert( ! precomputed<staticmeta<3, 1>> );
+
+static_assert( metaconst<staticmeta<3>> && metaconst<staticmeta<out>> );
+static_assert( metaconst<staticmeta<3>, int> );
+static_assert( ! metaconst<staticmeta<3>, long> );
+#endif
+static_assert( same_kind<staticmeta<3>, staticmeta<out>> );
+static_assert( same_kind<staticmeta<3>, staticmeta<3, 1>> );
+static_assert( same_kind<staticmeta<std::size_t{3}>, staticmeta<3ull>> );
+
+int get(dynameta<int> d) { return d() + int(d); }
+double get(dynameta<double> d) { return d(); }
+
+int main()
+{
+  int fails = 0;
+
+  // The members of the extern dynameta<T> are defined, in the one TU
+  // of parameta_extern.cpp, and link
+  fails += get(dynameta<int>{2}) != 4;
+  fails += get(dynameta<double>{0.5}) != 0.5;
+  fails += dynameta<bool>{true}() != true;
+
+  return fails;
+}
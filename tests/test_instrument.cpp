@@ -0,0 +1,96 @@
+#if __cpp_concepts
+#include "instrument.hpp"
+
+#include <thread>
+
+using namespace NAMESPACE_ID;
+
+int width = 16;
+int depth = 4;
+
+using W = staticmeta<(width), counted>;
+using D = staticmeta<(depth)>;
+using threads_t = dynameta<int, counted>;
+
+// A count from a static initializer, before any other, is of its type
+int early_value = 5;
+using early_t = staticmeta<(early_value), counted>;
+int early = early_t{}();
+
+// A count at thread exit, after the thread's block is retired, is lost,
+// with no access to the destroyed block
+struct late_reader
+{
+  ~late_reader() { late = W{}(); }
+  int late = 0;
+};
+
+// Only counted types are, unless all are, by LML_PARAMETA_INSTRUMENT
+static_assert( impl::access_counted<W>
+            && impl::access_counted<threads_t> );
+static_assert( impl::access_counted<D> == impl::count_all
+     && impl::access_counted<dynameta<int>> == impl::count_all );
+static_assert( ! impl::access_counted<staticmeta<16, counted>> );
+
+// Counted or not, the classification is unchanged
+static_assert( is_metastatic_v<W> && ! is_metaconst_v<W> );
+static_assert( is_metavalue_v<threads_t>
+          && ! is_metastatic_v<threads_t> );
+
+// Constant evaluation is not counted, nor is it precluded
+static_assert( threads_t{3}() == 3 );
+static_assert( &W{}() == &width );
+
+int read(threads_t const& t) { return t; }
+
+int main()
+{
+  int fails = 0;
+
+  threads_t threads{8};
+  dynameta<int> plain{2};
+
+  int sum = 0;
+  for (int i = 0; i != 10; ++i)
+    sum += threads() + plain() + W{}() + D{}();
+  sum += read(threads) + threads.value + W::value;
+  fails += sum != 10 * 30 + 8 + 8 + 16;
+
+  // Counts are per thread, summed over live and exited threads
+  int other_sum = 0;
+  std::thread t([&other_sum] {
+    threads_t other{1};
+    for (int i = 0; i != 100; ++i)
+      other_sum += W{}() + other();
+  });
+  t.join();
+  fails += other_sum != 100 * 17;
+
+  std::uint64_t const w0 = accesses<W>();
+  std::thread([] {
+    thread_local late_reader reader; // destroyed after the block
+    (void)reader;
+    (void)W{}();
+  }).join();
+  fails += accesses<W>() != w0 + 1;
+  fails += early != 5 || accesses<early_t>() != 1;
+
+  fails += accesses<threads_t>() != 10 + 1 + 100;
+  fails += accesses<W>() != 10 + 100 + 1;
+
+  if (! impl::count_all) {
+    auto const counts = access_counts();
+    fails += counts.size() != 3;
+    for (auto const& c : counts)
+      fails += c.name.find("counted") == c.name.npos
+            || c.count != (c.name.find("width") != c.name.npos ? 111
+                         : c.name.find("early") != c.name.npos ? 1
+                                                                : 111);
+  }
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
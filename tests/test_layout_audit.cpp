@@ -0,0 +1,86 @@
+#if __cpp_concepts
+
+#include "layout_audit.hpp"
+
+#include <memory>
+
+using namespace NAMESPACE_ID;
+using std::unique_ptr;
+
+// The readme example layouts and sizes, audited on every compiler
+
+template <typename T, int N> using array = ray<T[N], staticmeta<N>>;
+template <typename P> using span = ray<P,dynameta<int>>;
+
+char buffer[4];
+int extent = 4;
+
+using c4 = layout_audit_of<array<char,4>>;
+using ps = layout_audit_of<span<char*>>;
+using up = layout_audit_of<span<unique_ptr<char[]>>>;
+using sp = layout_audit_of<ray<char(&)[4], staticmeta<4>>>;
+using sb = layout_audit_of<ray<staticmeta<buffer>, staticmeta<4>>>;
+using pg = layout_audit_of<ray<char*, staticmeta<(extent)>>>;
+
+static_assert( ps::size == 16 && ps::dynamic_bytes == 12    // pointer,
+            && ps::padding == 4 && ps::zero_size );          // int, pad
+static_assert( up::size == 16 && up::padding == 4 && up::zero_size );
+static_assert( sp::size == 8 && sp::dynamic_bytes == 8      // reference
+            && sp::static_members == 1 && sp::zero_size );   // as pointer
+static_assert( c4::size == 4 && c4::padding == 0 && c4::zero_size );
+static_assert( sb::size == 1 && sb::dynamic_members == 0    // all static
+            && sb::static_members == 2 && sb::zero_size );
+static_assert( pg::size == 8 && pg::padding == 0 && pg::zero_size );
+
+// Alignment padding is counted as padding, not overhead
+using c3 = layout_audit_of<ray<char[3], staticmeta<3, align<64>>>>;
+static_assert( c3::size == 64 && c3::padding == 61 && c3::zero_size );
+
+// mdray, with only dynamic extents stored
+using X = extents<staticmeta<4>, dynameta<int>, dynameta<int>>;
+static_assert( layout_audit_of<X>::size == 8
+            && layout_audit_of<X>::static_members == 1
+            && layout_audit_of<X>::zero_size );
+using md = layout_audit_of<mdray<float*, X>>;
+static_assert( md::size == 16 && md::padding == 0 && md::zero_size );
+
+// number, the readme format, is only its code
+using q = layout_audit_of<number<staticmeta<8>, staticmeta<128>,
+                                 staticmeta<-4>>>;
+static_assert( q::size == 1 && q::static_members == 3 && q::zero_size );
+
+// and with the default zero Bias and Base, of distinct types, likewise
+using q8 = layout_audit_of<number<staticmeta<8>>>;
+static_assert( q8::size == 1 && q8::static_members == 3
+            && q8::overhead == 0 && q8::zero_size );
+
+// metastruct packs by alignment, so reorder can't save any more
+using ms = layout_audit_of<metastruct<dynameta<char>, staticmeta<1>,
+                                      dynameta<double>, dynameta<int>>>;
+static_assert( ms::size == 16 && ms::sorted_size == 16 && ms::zero_size
+            && ms::dynamic_members == 3 && ms::static_members == 1 );
+
+// A plain struct, audited by its member types, in declaration order
+struct loose { char a; double b; char c; [[no_unique_address]]
+                                         staticmeta<2> n; };
+using lo = layout_audit<loose, char, double, char, staticmeta<2>>;
+static_assert( lo::dynamic_bytes == 10 && lo::static_members == 1 );
+static_assert( lo::sorted_size == 16 && lo::packed_size == 24 );
+#ifndef _MSC_VER
+static_assert( lo::size == 24 && lo::padding == 14 && lo::zero_size );
+#endif
+
+// Two empty members of one type need distinct addresses: overhead
+struct twice { [[no_unique_address]] staticmeta<0> a;
+               [[no_unique_address]] staticmeta<0> b; char c; };
+using tw = layout_audit<twice, staticmeta<0>, staticmeta<0>, char>;
+static_assert( tw::packed_size == 1 );
+#ifndef _MSC_VER
+static_assert( tw::size == 2 && tw::overhead == 1 && ! tw::zero_size );
+#endif
+
+int main() {}
+
+#else
+int main() {}
+#endif
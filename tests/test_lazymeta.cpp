@@ -0,0 +1,93 @@
+#include "lazymeta.hpp"
+
+#include <thread>
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+std::atomic<int> probes{0};
+
+int probe() noexcept { ++probes; return 64; }
+double scale() { return 0.5; }
+
+// A lazymeta is a dynamic metavalue, of the generator's value type
+static_assert( is_metavalue_v<lazymeta<probe>>
+           && ! is_metastatic_v<lazymeta<probe>> );
+static_assert( SAME<lazymeta<probe>::value_type, int> );
+static_assert( SAME<lazymeta<scale>::value_type, double> );
+static_assert( noexcept(lazymeta<probe>{}())
+           && ! noexcept(lazymeta<scale>{}()) );
+
+// Constant initialized, so there's no startup cost
+#if __cpp_constinit
+constinit
+#endif
+lazymeta<probe> l2;
+
+// Its static id is a zero-size metastatic parameter
+using l2_t = staticmeta<(l2)>;
+static_assert( is_metastatic_v<l2_t> && std::is_empty_v<l2_t> );
+
+int throws_once_calls = 0;
+int throws_once()
+{
+  if (throws_once_calls++ == 0)
+    throw 1;
+  return 7;
+}
+
+std::atomic<int> slow_calls{0};
+int slow() noexcept
+{
+  ++slow_calls;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  return 3;
+}
+
+int main()
+{
+  int fails = 0;
+
+  // Nothing is computed until the first read, then only once
+  fails += l2.ready() || probes != 0;
+  fails += l2() != 64 || probes != 1 || ! l2.ready();
+  fails += int(l2) != 64 || l2_t{}() != 64 || probes != 1;
+
+  int from_static = l2_t{}();
+  fails += from_static != 64;
+
+  // Initialized to a value, the generator is never called
+  lazymeta<probe> preset{32};
+  fails += ! preset.ready() || preset() != 32 || probes != 1;
+
+  // set(v) sets the value only if not yet computed
+  lazymeta<probe> loaded;
+  fails += ! loaded.set(16) || ! loaded.ready() || loaded() != 16;
+  fails += loaded.set(8) || loaded() != 16 || probes != 1;
+
+  // A copy is of the value if computed, else uncomputed
+  lazymeta<probe> fresh, copied = l2;
+  lazymeta<probe> uncomputed = fresh;
+  fails += ! copied.ready() || copied() != 64 || uncomputed.ready();
+
+  // A throwing generator leaves it uncomputed, to retry on next read
+  lazymeta<throws_once> retry;
+  try { (void)retry(); fails += 1; }
+  catch (int) { fails += retry.ready(); }
+  fails += retry() != 7 || throws_once_calls != 2;
+
+  // Concurrent first readers wait for the one computation
+  lazymeta<slow> shared;
+  int seen[4]{};
+  std::thread readers[4];
+  for (int i = 0; i != 4; ++i)
+    readers[i] = std::thread([&, i] { seen[i] = shared(); });
+  for (auto& t : readers)
+    t.join();
+  for (int s : seen)
+    fails += s != 3;
+  fails += slow_calls != 1;
+
+  return fails;
+}
@@ -0,0 +1,45 @@
+// Macro hygiene: the library headers neither leak nor clobber macros,
+// so they can be put in a precompiled header next to any user code.
+// User macros of the same names as the local macros are given values,
+// to be checked after; the others must not be defined after.
+#define typeof 1
+#define MSVCONST 2
+#define SAME 3
+#define REMOVE_REF_T 4
+#define REMOVE_CVREF_T 5
+#define NUA 6
+#define NAMESPACE_ID_IS_EMPTY 7
+
+#include "parameta.hpp"
+#include "dispatch_static.hpp"
+#include "tunable.hpp"
+#if __cpp_concepts
+#include "mdray.hpp"
+#include "number_kernels.hpp"
+#endif
+
+#if typeof != 1 || MSVCONST != 2 || SAME != 3 || REMOVE_REF_T != 4 \
+ || REMOVE_CVREF_T != 5 || NUA != 6 || NAMESPACE_ID_IS_EMPTY != 7
+# error "a library header clobbered a user macro"
+#endif
+
+#if defined CONSTEVAL || defined STATIC_CALL || defined STATIC_CALL_CV \
+ || defined STATICMETA_V_X || defined METADATA_ACCESS_H
+# error "parameta.hpp leaked a local macro"
+#endif
+
+#if defined LML_NAMESPACE_OPEN || defined LML_NS_IS_EMPTY
+# error "namespace.hpp left its namespace open"
+#endif
+
+#undef typeof
+#undef SAME
+#undef NUA
+
+// The configuration macro is kept, as the library's namespace
+using namespace NAMESPACE_ID;
+
+static_assert( is_metaconst_v<staticmeta<1>> );
+static_assert( staticmeta<1,'x'>::metaget<0>() == 'x' );
+
+int main() {}
@@ -0,0 +1,93 @@
+#if __cpp_concepts
+#include "mdray.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+int g = 3; // static global extent
+
+using s4 = staticmeta<4>;
+using s8 = staticmeta<8>;
+using sg = staticmeta<(g)>;
+using di = dynameta<int>;
+
+// Only dynamic extents take storage
+static_assert( sizeof(extents<s4,s8>) == 1 && std::is_empty_v<extents<s4,s8>>
+            && sizeof(extents<s4,sg,s8>) == 1
+            && sizeof(extents<s4,di>) == sizeof(int)
+            && sizeof(extents<di,s8,di>) == 2 * sizeof(int) );
+
+static_assert( extents<s4,sg,di>::rank() == 3
+            && extents<s4,sg,di>::rank_dynamic() == 1 );
+
+constexpr extents<di,s8,di> x{2,5};
+static_assert( x.extent<0>() == 2 && x.extent<1>() == 8
+            && x.extent<2>() == 5 && x.size() == 80 );
+static_assert( SAME<decltype(x.get<1>()), s8>
+            && SAME<decltype(x.get<2>()), di> );
+
+// Layout mappings
+using x48 = extents<s4,s8>;
+using right = layout_right::mapping<x48>;
+using left = layout_left::mapping<x48>;
+using tiled = layout_blocked::mapping<x48,2,4>;
+
+static_assert( right::offset(x48{},0,0) == 0 && right::offset(x48{},1,0) == 8
+            && right::offset(x48{},3,7) == 31 );
+static_assert( left::offset(x48{},1,0) == 1 && left::offset(x48{},0,1) == 4
+            && left::offset(x48{},3,7) == 31 );
+
+// 4x8 in 2x4 tiles: tile (0,0) is offsets 0..7, tile (0,1) 8..15, ...
+static_assert( tiled::offset(x48{},0,3) == 3 && tiled::offset(x48{},1,0) == 4
+            && tiled::offset(x48{},0,4) == 8 && tiled::offset(x48{},2,0) == 16
+            && tiled::offset(x48{},3,7) == 31
+            && tiled::required_span_size(x48{}) == 32 );
+
+// Partial tiles are padded
+using x35 = extents<staticmeta<3>,staticmeta<5>>;
+static_assert( layout_blocked::mapping<x35,2,2>::required_span_size(x35{})
+               == 2*3*4 );
+
+// mdray
+float buf[32];
+
+using m48 = mdray<float*, x48>;
+using m4d = mdray<float*, extents<s4,di>, typemeta<layout_left>>;
+using mst = mdray<staticmeta<buf>, x48, typemeta<layout_blocked,2,4>>;
+
+static_assert( sizeof(m48) == sizeof(float*)
+            && sizeof(m4d) == 2 * sizeof(float*)
+            && sizeof(mst) == 1 );
+static_assert( m48::rank() == 2 && SAME<m48::value_type, float> );
+
+constexpr auto iota = [] {
+  mdray<int[12], extents<staticmeta<3>,di>> m{{}, {4}};
+  int n = 0;
+  for (int i = 0; i != 3; ++i)
+    for (int j = 0; j != 4; ++j)
+      m(i,j) = n++;
+  return m;
+}();
+static_assert( iota.storage[7] == 7 && iota(1,3) == 7
+            && iota.required_span_size() == 12 );
+
+int main()
+{
+  m4d ml{buf, {8}};
+  ml(3,7) = 1;
+  if (buf[31] != 1) return 1;
+
+  mst mb{};
+  mb(2,5) = 2;
+  if (buf[16 + 8 + 1] != 2) return 1;
+
+  mdray<float*, extents<sg,s8>> mg{buf};
+  if (mg.size() != 24) return 1;
+  g = 4;
+  if (mg.size() != 32 || &mg(3,7) != buf + 31) return 1;
+}
+
+#else
+int main() {}
+#endif
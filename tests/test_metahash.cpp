@@ -0,0 +1,85 @@
+#if __cpp_concepts
+#include "registry.hpp"  // first, for its impl::fnv1a function
+#include "metahash.hpp"
+
+using namespace NAMESPACE_ID;
+
+int g = 1;
+int h = 2;
+
+struct tile { static constexpr std::string_view meta_name = "tile"; };
+struct key { char s[8]; };
+enum class op : short { add, mul };
+
+// registry's string hash and the meta hasher coexist, in either order
+static_assert( impl::fnv1a("") == impl::fnv1a_state{}.h );
+
+// Constant and distinct, for values, types and metadata, in order
+using S8 = staticmeta<8>;
+static_assert( meta_hash_v<S8> == meta_hash(S8{}) );
+static_assert( meta_hash_v<S8> != meta_hash_v<staticmeta<8u>>
+            && meta_hash_v<S8> != meta_hash_v<staticmeta<9>>
+            && meta_hash_v<S8> != meta_hash_v<staticmeta<8, 1>>
+            && meta_hash_v<staticmeta<8, 1, 2>>
+            != meta_hash_v<staticmeta<8, 2, 1>> );
+static_assert( meta_hash_v<dynameta<int>> != meta_hash_v<typemeta<int>>
+            && meta_hash_v<dynameta<int>> != meta_hash_v<dynameta<int&>>
+            && meta_hash_v<typemeta<int const*>>
+            != meta_hash_v<typemeta<int*>>
+            && meta_hash_v<typemeta<int[4]>>
+            != meta_hash_v<typemeta<int[5]>> );
+static_assert( meta_hash_v<staticmeta<0.5>>
+            != meta_hash_v<staticmeta<0.25>>
+            && meta_hash_v<staticmeta<op::add>>
+            != meta_hash_v<staticmeta<op::mul>> );
+
+// Static ids by entity; class values by bytes, class types by name
+using G = staticmeta<(g)>;
+static_assert( meta_hash_v<G> != meta_hash_v<staticmeta<(h)>>
+            && meta_hash_v<G> != meta_hash_v<staticmeta<1>> );
+static_assert( meta_hash_v<staticmeta<key{"ab"}>>
+            != meta_hash_v<staticmeta<key{"ba"}>> );
+static_assert( meta_hash_v<typemeta<tile>>
+            != meta_hash_v<typemeta<key>> );
+
+// Meta types in metadata hash recursively
+static_assert( meta_hash_v<staticmeta<8, typemeta<float>{}>>
+            != meta_hash_v<staticmeta<8, typemeta<double>{}>> );
+static_assert( meta_hash_v<typemeta<staticmeta<8>>>
+            != meta_hash_v<typemeta<staticmeta<16>>> );
+
+// The encoding is fixed, so these hashes are for any build, anywhere
+static_assert( meta_hash_v<S8> == 0xd4570537a0172f71 );
+static_assert( meta_hash_v<dynameta<unsigned, typemeta<tile>{}>>
+               == 0xa7669a7136325db4 );
+
+// Dense ids, by compile-time lookup, or from a runtime hash
+using kernels = meta_ids<staticmeta<8, typemeta<float>{}>,
+                         staticmeta<16, typemeta<float>{}>,
+                         staticmeta<8, typemeta<double>{}>>;
+static_assert( kernels::size() == 3 );
+static_assert( kernels::id<staticmeta<8, typemeta<double>{}>> == 2 );
+static_assert( kernels::index(meta_hash_v<staticmeta<16,
+                                          typemeta<float>{}>>) == 1 );
+static_assert( kernels::index(meta_hash_v<S8>) == 3 );
+
+template <typename K>
+concept kernel_id = requires { kernels::id<K>; };
+static_assert( ! kernel_id<S8> );
+
+int main()
+{
+  int fails = 0;
+  using F8 = staticmeta<8, typemeta<float>{}>;
+  using D8 = staticmeta<8, typemeta<double>{}>;
+  std::uint64_t const hs[]{meta_hash_v<F8>, meta_hash_v<D8>,
+                           meta_hash_v<S8>};
+  std::size_t const ids[]{0, 2, 3};
+  for (int i = 0; i != 3; ++i)
+    fails += kernels::index(hs[i]) != ids[i];
+  return fails;
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,69 @@
+#if __cpp_concepts
+
+#include "metastruct.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+int g = 3;
+
+// Only the dynamic parameters are stored, by decreasing alignment
+using mixed = metastruct<dynameta<char>, staticmeta<64>, dynameta<double>,
+                         staticmeta<(g)>, dynameta<int>, dynameta<char>>;
+
+static_assert( sizeof(mixed) == 16 );  // double, int, char, char, pad 2
+static_assert( mixed::size() == 6 && mixed::dynamic() == 4 );
+
+// Declaration order has 7 bytes padding after each char, and 4 after int
+struct naive { char a; double b; int c; char d; };
+static_assert( sizeof(naive) == 24 );
+
+constexpr mixed m{'a', 0.5, 7, 'z'};
+
+static_assert( get<0>(m)() == 'a' && get<2>(m)() == 0.5 );
+static_assert( get<4>(m)() == 7 && get<5>(m)() == 'z' );
+static_assert( SAME<decltype(get<1>(m)), staticmeta<64>> );
+static_assert( get<1>(m)() == 64 );
+static_assert( SAME<decltype(get<0>(m)), dynameta<char> const&> );
+static_assert( is_metastatic_v<decltype(get<3>(m))> );
+
+// All static: an empty struct
+using none = metastruct<staticmeta<1>, staticmeta<(g)>>;
+static_assert( std::is_empty_v<none> && none::dynamic() == 0 );
+
+// Tag access through typemeta metadata
+struct batch; struct scale; struct spin;
+
+using tuning = metastruct<dynameta<int, typemeta<batch>{}>,
+                          staticmeta<0.5, typemeta<scale>{}>,
+                          dynameta<short, 'x', typemeta<spin>{}>>;
+
+static_assert( sizeof(tuning) == 8 );
+
+constexpr tuning t{64, 100};
+static_assert( get<batch>(t)() == 64 && get<spin>(t)() == 100 );
+static_assert( get<scale>(t)() == 0.5 );
+static_assert( is_metaconst_v<decltype(get<scale>(t))> );
+
+// Alignment beyond the fundamental, packed first
+struct alignas(32) vec { float f[8]; };
+using aligned = metastruct<dynameta<char>, dynameta<vec>, dynameta<int>>;
+static_assert( sizeof(aligned) == 64 && alignof(aligned) == 32 );
+
+// A dynamic reference parameter binds to the constructor argument
+using refs = metastruct<dynameta<int&>, staticmeta<2>>;
+
+int main()
+{
+  tuning u{1, 2};
+  get<batch>(u).value = 128;
+  refs r{g};
+  get<0>(r).value = 5;
+  return get<batch>(u)() == 128 && get<spin>(u)() == 2 && g == 5
+       ? 0 : 1;
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,89 @@
+#include "metatable.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+// as_array : a static constexpr std::array of the common value type
+static_assert( SAME<decltype(as_array(staticmeta<1,2,3>{})),
+                    std::array<int,3> const&> );
+static_assert( as_array(staticmeta<1,2,3>{})[2] == 3 );
+static_assert( SAME<decltype(as_array(staticmeta<'a',2L>{})),
+                    std::array<long,2> const&> );
+static_assert( &as_array(staticmeta<9,8>{})
+            == &as_array(staticmeta<1,9,8>{}.metaget()) );
+
+// Opcode to latency, a dense enum key range: direct slot lookup
+enum class op : unsigned char { add, sub, mul, div, sqrt, fma };
+
+using latency = metatable<staticmeta<op::add, op::mul, op::div, op::fma>,
+                          staticmeta<1,       3,       24,      4>>;
+
+static_assert( latency::lookup == metatable_lookup::direct );
+static_assert( latency::size() == 4 );
+static_assert( *latency::find(op::div) == 24 );
+static_assert( *latency::find(op::fma) == 4 );
+static_assert( latency::find(op::sub) == nullptr );
+static_assert( latency::find(op(200)) == nullptr );
+static_assert( latency::index(op::mul) == 1 );
+static_assert( latency::contains(op::add)
+            && ! latency::contains(op::sqrt) );
+
+// Format id to bit width, sparse keys: perfect multiplicative hash
+using formats = staticmeta<0x10, 0x4000, 0x8001, 1000000, -7>;
+using width = metatable<formats, staticmeta<8, 16, 12, 64, 32>>;
+
+static_assert( width::lookup == metatable_lookup::hashed );
+static_assert( *width::find(0x4000) == 16 && *width::find(-7) == 32 );
+static_assert( *width::find(1000000) == 64 && *width::find(0x10) == 8 );
+static_assert( width::find(0x11) == nullptr && width::find(0) == nullptr );
+static_assert( width::index(0x8001) == 2 );
+
+// A set, of keys taken as metadata by metaget<I...>() or meta(f)
+using sizes = typemeta<void, 1, 4096, 64, 16, 1 << 20>;
+using sizeset = metatable<decltype(sizes::metaget())>;
+
+static_assert( sizeset::lookup == metatable_lookup::hashed );
+static_assert( sizeset::contains(64) && ! sizeset::contains(32) );
+static_assert( *sizeset::find(4096) == 4096 );
+static_assert( sizeset::find(4096) == &sizeset::keys()[1] );
+
+struct as_set {
+  template <decltype(auto)...x>
+  constexpr auto operator()() const
+                             { return metatable<staticmeta<x...>>{}; }
+};
+using sizeset2 = decltype(sizes::meta(as_set{}));
+static_assert( SAME<sizeset, sizeset2> );
+
+// Single key and negative keys
+static_assert( metatable<staticmeta<-3>>::contains(-3) );
+static_assert( ! metatable<staticmeta<-3>>::contains(3) );
+static_assert( metatable<staticmeta<-3>>::lookup
+               == metatable_lookup::direct );
+static_assert( metatable<staticmeta<-9,-1,-5>>::index(-5) == 2 );
+
+#if __cpp_nontype_template_args >= 201911L
+// Floating point keys: sorted binary search
+using scale = metatable<staticmeta<0.5, 2.0, 0.25, 8.0, 1.0>,
+                        staticmeta<'h', 'd', 'q', 'o', 'u'>>;
+static_assert( scale::lookup == metatable_lookup::sorted );
+static_assert( *scale::find(0.25) == 'q' && *scale::find(8.0) == 'o' );
+static_assert( *scale::find(0.5) == 'h' && *scale::find(1.0) == 'u' );
+static_assert( scale::find(4.0) == nullptr && scale::find(9.) == nullptr );
+static_assert( scale::find(0.0) == nullptr );
+#endif
+
+int main()
+{
+  int fails = 0;
+  volatile int k = 0x4000;
+  fails += *width::find(int(k)) != 16;
+  k = 0x4001;
+  fails += width::find(int(k)) != nullptr;
+  volatile op o = op::fma;
+  fails += *latency::find(op(o)) != 4;
+  for (int s : sizeset::keys())
+    fails += ! sizeset::contains(s) || sizeset::contains(s + 1);
+  return fails;
+}
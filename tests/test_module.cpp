@@ -0,0 +1,41 @@
+// Test of the parameta named module, parameta.cppm, built with the same
+// NAMESPACE_ID as this importer; module macros are not imported
+#include <type_traits>
+
+import parameta;
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+int g;
+inline constexpr int c = 4;
+
+using C = staticmeta<1,'m'>;
+using S = staticmeta<(g),'s'>;
+using D = dynameta<int,'d'>;
+using T = typemeta<int,'t'>;
+
+// The concept gates, in parameta_traits.hpp, classify through the module
+static_assert( is_metaconst_v<C> && is_metastatic_v<S>
+           && ! is_metaconst_v<S> && is_metavalue_v<D>
+           && ! is_metastatic_v<D> && is_metatype_v<T> );
+static_assert( is_metapara_v<C> && is_metapara_v<T> );
+
+static_assert( metaconst<C> && metastatic<S> && metavalue<D>
+            && metatype<T> );
+
+// metadata_access.h is expanded in each exported class template
+static_assert( C::metasize() == 1 && C::metaget<0>() == 'm' );
+static_assert( T::metaget<0>() == 't' );
+static_assert( SAME<C::value_type, int> && SAME<T::type, int> );
+
+static_assert( is_metaconst_v<decltype(makestatic<c>())> );
+static_assert( is_metastatic_v<decltype(makestatic<g>())> );
+
+int main()
+{
+  S{}() = 2;
+  D d{3};
+  return g + d() == 5 ? 0 : 1;
+}
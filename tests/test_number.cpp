@@ -0,0 +1,124 @@
+#if __cpp_concepts
+#include "number.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+// q4_4 : 8-bit code, offset binary, in 1/16ths
+using q4_4 = number<staticmeta<8>, staticmeta<128>, staticmeta<-4>>;
+
+static_assert( sizeof(q4_4) == 1 && SAME<q4_4::code_type, std::uint8_t> );
+static_assert( SAME<number<staticmeta<9>>::code_type, std::uint16_t>
+            && SAME<number<staticmeta<33>>::code_type, std::uint64_t>
+            && SAME<number<dynameta<int>>::code_type, std::uint64_t> );
+
+constexpr q4_4 one_half = q4_4{}.from(1.5);
+static_assert( one_half.code == 128 + 24 && one_half.unpack() == 24
+            && one_half.to() == 1.5 && one_half.to<float>() == 1.5f );
+
+static_assert( q4_4{}.from(-8.0).code == 0
+            && q4_4{}.from(-0.03125).unpack() == -1 // rounds to nearest
+            && q4_4{}.pack(127).to() == 127 / 16.0 );
+
+// Codes wrap modulo 2^Width
+static_assert( q4_4{}.pack(128).code == 0 && q4_4{}.pack(-129).code == 255 );
+
+// Arithmetic, with the product rescaled by Base
+constexpr q4_4 three = q4_4{}.from(3.0);
+static_assert( (one_half + three).to() == 4.5
+            && (one_half - three).to() == -1.5
+            && (one_half * three).to() == 4.5
+            && one_half * three == one_half + three
+            && (one_half * one_half).to() == 2.25 );
+
+// Positive Base, and the default zero Bias and Base
+using by4 = number<staticmeta<16>, staticmeta<0>, staticmeta<2>>;
+static_assert( by4{}.from(100.0).code == 25 && by4{}.pack(3).to() == 12 );
+static_assert( number<staticmeta<1>>{}.pack(3).code == 1
+            && number<staticmeta<64>>{}.pack(-1).code == ~std::uint64_t{} );
+
+// The zero defaults are distinct, so the static parameters take no room
+static_assert( sizeof(number<staticmeta<8>>) == 1
+            && sizeof(number<staticmeta<8>, staticmeta<128>>) == 1
+            && ! SAME<zero_bias, zero_base> );
+
+// Width 64: wide codes, sums and exact 128-bit products, with no UB
+using w64 = number<staticmeta<64>>;
+using q32_32 = number<staticmeta<64>, staticmeta<0>, staticmeta<-32>>;
+constexpr std::int64_t min64 = INT64_MIN, max64 = INT64_MAX;
+
+static_assert( w64{}.pack(min64).code == std::uint64_t{1} << 63
+            && w64{}.pack(min64).unpack() == min64
+            && (w64{}.pack(max64) + w64{}.pack(1)).unpack() == min64
+            && (w64{}.pack(min64) - w64{}.pack(1)).unpack() == max64
+            && (w64{}.pack(max64) * w64{}.pack(max64)).unpack() == 1 );
+static_assert(
+  number<staticmeta<64>, staticmeta<min64>>{}.pack(max64).unpack()
+                                                         == max64 );
+static_assert( (q32_32{}.from(3.0) * q32_32{}.from(5.0)).to() == 15
+            && (q32_32{}.from(-3.0) * q32_32{}.from(5.0)).to() == -15
+            && (q32_32{}.from(-0.5) * q32_32{}.from(0.5)).to() == -0.25
+            && (q32_32{}.from(0x1p20) * q32_32{}.from(0x1p11)).to()
+                                                   == -0x1p31 ); // wraps
+
+// from(x) saturates, out of int64_t range; NaN is 0
+static_assert( w64{}.from(1e30).unpack() == max64
+            && w64{}.from(-1e30).unpack() == min64
+            && w64{}.from(0x1p63).unpack() == max64
+            && w64{}.from(-0x1p63).unpack() == min64
+            && w64{}.from(__builtin_nan("")).unpack() == 0 );
+
+// Large exponents, to |Base| 63; products shift out to 0 or the sign
+using up63 = number<staticmeta<16>, staticmeta<0>, staticmeta<63>>;
+using down63 = number<staticmeta<16>, staticmeta<1 << 15>,
+                      staticmeta<-63>>;
+static_assert( (up63{}.pack(1) * up63{}.pack(1)).unpack() == 0
+            && (down63{}.pack(1) * down63{}.pack(1)).unpack() == 0
+            && (down63{}.pack(-1) * down63{}.pack(1)).unpack() == -1
+            && down63{}.pack(1).to() == 0x1p-63 );
+static_assert( impl::valid_base<staticmeta<-63>>()
+            && ! impl::valid_base<staticmeta<64>>()
+            && ! impl::valid_base<staticmeta<-64>>() );
+
+// A runtime-parameterized format, for prototyping, takes storage
+using dyn = number<dynameta<int>, dynameta<int>, dynameta<int>>;
+static_assert( sizeof(dyn) == 3 * sizeof(int) + 4 + sizeof(std::uint64_t) );
+
+int main()
+{
+  dyn d{{8}, {128}, {-4}};
+  d.from(1.5);
+  if (d.code != one_half.code || d.to() != 1.5) return 1;
+
+  dyn t = d;
+  t.from(3.0);
+  if ((d * t).to() != 4.5 || (d - t).to() != -1.5) return 1;
+
+  d.width = {4};
+  d.bias = {0};
+  d.base = {0};
+  if (d.pack(17).code != 1) return 1;
+
+  // An out of range dynamic Width clamps its mask, with no UB shift
+  d.width = {0};
+  if (d.mask() != 0 || d.pack(5).code != 0) return 1;
+  d.width = {65};
+  if (d.mask() != ~std::uint64_t{} || d.pack(-1).code != d.mask())
+    return 1;
+
+  // A dynamic Base past 63 shifts products out, with no UB shift
+  d.width = {64};
+  d.base = {100};
+  dyn a = d, b = d;
+  if ((a.pack(3) * b.pack(5)).unpack() != 0) return 1;
+  a.base = b.base = d.base = {-100};
+  if ((a.pack(-3) * b.pack(5)).unpack() != -1
+   || (a.pack(3) * b.pack(5)).unpack() != 0) return 1;
+  d.base = {-1000};
+  if (d.from(1.0).unpack() != max64) return 1;  // saturates
+}
+
+#else
+int main() {}
+#endif
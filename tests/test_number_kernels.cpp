@@ -0,0 +1,127 @@
+#if __cpp_concepts
+#include "number_kernels.hpp"
+#include "ray.hpp"
+
+#include <array>
+#include <climits>
+#include <vector>
+
+using namespace NAMESPACE_ID;
+
+using q4_4 = number<staticmeta<8>, staticmeta<128>, staticmeta<-4>>;
+using q8_8 = number<staticmeta<16>, staticmeta<0>, staticmeta<-8>>;
+
+// Constant formats and extents are constexpr
+constexpr auto quantized = [] {
+  ray<float[4], staticmeta<4>> x{{1.5f, -2.f, 0.03125f, 7.9375f}};
+  ray<std::uint8_t[4], staticmeta<4>> c{};
+  pack(q4_4{}, x, c);
+  return c;
+}();
+static_assert( quantized[0] == 128 + 24 && quantized[1] == 128 - 32
+            && quantized[2] == 129 && quantized[3] == 255 );
+
+constexpr auto dequantized = [] {
+  std::array<double,4> v{};
+  unpack(q4_4{}, quantized, v);
+  return v;
+}();
+static_assert( dequantized[0] == 1.5 && dequantized[1] == -2
+            && dequantized[2] == 0.0625 && dequantized[3] == 7.9375 );
+
+// Recoding between formats; the wider Base shifts left, else right
+constexpr auto recoded = [] {
+  std::array<std::uint16_t,4> w{};
+  convert(q4_4{}, quantized, q8_8{}, w);
+  std::array<std::uint8_t,4> n{};
+  convert(q8_8{}, w, q4_4{}, n);
+  return std::pair{w, n};
+}();
+static_assert( recoded.first[0] == 384 && recoded.first[1] == 0xfe00
+            && recoded.first[2] == 16 && recoded.first[3] == 2032 );
+static_assert( recoded.second[0] == quantized[0]
+            && recoded.second[1] == quantized[1]
+            && recoded.second[2] == quantized[2]
+            && recoded.second[3] == quantized[3] );
+
+// Shifts past the width of the 32-bit intermediate, and products that
+// overflow it, wrap or shift out, with no UB
+template <typename Src, typename Dst>
+constexpr std::array<std::uint16_t,2> recode(std::uint16_t a,
+                                             std::uint16_t b)
+{
+  std::array<std::uint16_t,2> const c{a, b};
+  std::array<std::uint16_t,2> d{};
+  convert(Src{}, c, Dst{}, d);
+  return d;
+}
+using up40 = number<staticmeta<16>, staticmeta<0>, staticmeta<40>>;
+using up20 = number<staticmeta<16>, staticmeta<0>, staticmeta<20>>;
+using mid = number<staticmeta<16>, staticmeta<1 << 15>>;
+using at0 = number<staticmeta<16>, staticmeta<5>>;
+using at40 = number<staticmeta<16>, staticmeta<100>, staticmeta<40>>;
+static_assert( recode<up40, at0>(1, 0xffff)
+                              == std::array<std::uint16_t,2>{5, 5} );
+static_assert( recode<up20, at0>(0xffff, 0x8001)
+                              == std::array<std::uint16_t,2>{5, 5} );
+static_assert( recode<mid, at40>(0, 0xffff)
+                              == std::array<std::uint16_t,2>{99, 100} );
+
+// 32-bit codes of values past INT32_MAX agree with the scalar number
+using u32 = number<staticmeta<32>>;
+constexpr auto wide = [] {
+  std::array<std::uint32_t,2> c{3000000000u, 0xffffffffu};
+  std::array<double,2> v{};
+  unpack(u32{}, c, v);
+  std::array<std::uint32_t,2> r{};
+  pack(u32{}, v, r);
+  return std::pair{v, r};
+}();
+static_assert( wide.first[0] == 3e9 && wide.first[0]
+                            == u32{{}, {}, {}, 3000000000u}.to()
+            && wide.first[1] == 4294967295.0 );
+static_assert( wide.second[0] == 3000000000u
+            && wide.second[1] == 0xffffffffu );
+
+int main()
+{
+  // A runtime format, with Width dispatched to a constant mask kernel
+  using dyn = number<dynameta<int>, dynameta<int>, dynameta<int>>;
+  std::vector<float> x(1000);
+  for (std::size_t i = 0; i != x.size(); ++i)
+    x[i] = float(i % 256) / 16 - 8;
+
+  for (int width : {8, 12}) {
+    dyn fmt{{width}, {128}, {-4}};
+    std::vector<std::uint16_t> c(x.size());
+    pack(fmt, x, c);
+    std::vector<float> y(x.size());
+    unpack(fmt, c, y);
+    for (std::size_t i = 0; i != x.size(); ++i)
+      if (y[i] != x[i] || c[i] != dyn{fmt}.from(x[i]).code)
+        return 1;
+  }
+
+  // Codes wrap in a narrow format, dispatched or not
+  dyn narrow{{4}, {0}, {0}};
+  float const big[]{17.f, 3.f};
+  std::uint8_t c[2];
+  pack<staticmeta<4>>(narrow, big, c);
+  if (c[0] != 1 || c[1] != 3) return 1;
+  pack<staticmeta<8>>(narrow, big, c);
+  if (c[0] != 1 || c[1] != 3) return 1;
+
+  // Dynamic exponents far apart, even past the range of int when
+  // subtracted, shift out, with no UB
+  dyn far_up{{16}, {0}, {INT_MAX}}, far_down{{16}, {7}, {-INT_MAX}};
+  std::uint16_t const s[]{3, 0xffff};
+  std::uint16_t d[2];
+  convert(far_up, s, far_down, d);
+  if (d[0] != 7 || d[1] != 7) return 1;
+  convert(far_down, s, far_up, d);
+  if (d[0] != 0xffff || d[1] != 0) return 1;
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,118 @@
+#if __cpp_concepts
+#include "parallel.hpp"
+
+#include <atomic>
+#include <string>
+
+using namespace NAMESPACE_ID;
+
+// Constant extent and chunk count: a constexpr table of chunk bounds,
+// at multiples of a cache line of elements, 16 ints
+using plan = impl::static_chunks<1000, 4, impl::line_elements<int>>;
+static_assert( plan::step == 256 && plan::count == 4 );
+static_assert( plan::bounds[1] == 256 && plan::bounds[4] == 1000 );
+
+// Short arrays take fewer chunks, of whole cache lines
+static_assert( impl::static_chunks<20, 8, 16>::count == 2 );
+static_assert( impl::static_chunks<0, 8, 16>::count == 0 );
+
+// Sizes are static for metaconst extents, of a ray or mdray
+static_assert( impl::static_size<ray<int[64], staticmeta<64>>>() == 64 );
+static_assert( impl::static_size<ray<int*, dynameta<int>>>()
+               == impl::dynamic_size );
+static_assert( impl::static_size<mdray<int*,
+                 extents<staticmeta<4>, staticmeta<8>>>>() == 32 );
+static_assert( impl::static_size<mdray<int*,
+                 extents<staticmeta<4>, dynameta<int>>>>()
+               == impl::dynamic_size );
+
+// A blocked mdray, with padding, isn't dense
+template <typename R>
+concept par_ok = requires (R& r) {
+  for_each(par_static<2>, r, [](auto&) {});
+};
+static_assert( par_ok<ray<int[64], staticmeta<64>>>
+            && par_ok<mdray<int*, extents<staticmeta<4>, dynameta<int>>,
+                            typemeta<layout_left>>>
+            && ! par_ok<mdray<int*, extents<staticmeta<4>,staticmeta<4>>,
+                              typemeta<layout_blocked,2,2>>> );
+
+inline constexpr std::size_t chunk_limit = 8;
+
+// A counting executor, to check the chunks run
+struct counting
+{
+  std::atomic<std::size_t>* ran;
+  template <typename F>
+  void operator()(std::size_t tasks, F& task) const
+  {
+    thread_executor{}(tasks, task);
+    *ran += tasks;
+  }
+};
+
+// bounds_at(pol, p, n) : the chunk bounds of n ints at p
+template <std::size_t N, typename P>
+std::vector<std::size_t> bounds_at(P const& pol, int const* p,
+                                   std::size_t n)
+{
+  std::vector<std::size_t> b(chunk_limit + 1, n);
+  impl::par_chunks<int, N>(pol.on(inline_executor{}), p, n,
+    [&b](std::size_t k, std::size_t lo, std::size_t) { b[k] = lo; });
+  return b;
+}
+
+int main()
+{
+  int fails = 0;
+
+  // Inner chunk bounds fall on cache lines of the data, not of data()
+  // offsets, for line aligned or misaligned data, static or dynamic
+  alignas(64) static int lines[1024];
+  for (int const* p : {lines + 0, lines + 3, lines + 15}) {
+    auto const s = bounds_at<1000>(par_static<4>, p, 1000);
+    auto const d = bounds_at<impl::dynamic_size>(par(4), p, 1000);
+    fails += s != d || s[0] != 0;
+    for (std::size_t k = 1; k != 4; ++k)
+      fails += s[k] <= s[k - 1] || s[k] >= 1000
+            || reinterpret_cast<std::uintptr_t>(p + s[k]) % 64 != 0;
+  }
+
+  ray<int[1000], staticmeta<1000>> a{};
+  for_each(par_static<4>, a, [](int& x) { x = 1; });
+  fails += reduce(par_static<4>, a, 0) != 1000;
+
+  std::atomic<std::size_t> ran{0};
+  std::size_t const n = 777;
+  std::vector<long> v(n);
+  ray<long*, dynameta<std::size_t>> d{v.data(), {n}};
+  // Dynamic sizes adapt at runtime; 777 longs of 8 per line, 4 chunks
+  for_each(par(4).on(counting{&ran}), d, [](long& x) { x = 2; });
+  fails += ran != 4;
+  fails += transform_reduce(par(4), d, 0L, std::plus<>{},
+                            [](long x) { return x * x; }) != 4 * 777;
+
+  // A dynamic input of a static output's size
+  ray<long[600], staticmeta<600>> t{};
+  ray<long const*, dynameta<int>> d6{v.data(), {600}};
+  transform(par_static<2>, d6, t, [](long x) { return -x; });
+  fails += t[0] != -2 || t[599] != -2 || reduce(par(), t, 0L) != -1200;
+
+  // Reductions combine in element order, for an op not commutative
+  ray<std::string[10], staticmeta<10>> s{
+                           {"a","b","c","d","e","f","g","h","i","j"}};
+  fails += reduce(par_static<3>, s, std::string{">"}) != ">abcdefghij";
+  fails += reduce(par_static<3>.on(inline_executor{}), s,
+                  std::string{}) != "abcdefghij";
+
+  int m[4][8]{};
+  mdray<int*, extents<staticmeta<4>, staticmeta<8>>> md{&m[0][0]};
+  for_each(par_static<2>, md, [](int& x) { x = 3; });
+  fails += reduce(par(), md, 0) != 96 || m[3][7] != 3;
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
@@ -221,6 +221,35 @@ test_metastatic<static_cast<void(&)()noexcept>(function)>
 #endif
 metastatic_function;
 
+// An empty metavalue with no default constructor is not metastatic
+struct nodefault {
+  using value_type = int;
+  static constexpr int value = 0;
+  constexpr explicit nodefault(int) {}
+  constexpr int operator()() const { return value; }
+  constexpr operator int() const { return value; }
+};
+static_assert(   METAVALUE(nodefault) );
+static_assert( ! METASTATIC(nodefault) && ! METACONST(nodefault) );
+
+#if __cpp_concepts
+// The meta value concepts subsume; the most constrained overload wins
+template <metavalue Q>  constexpr int constraint(Q) { return 1; }
+template <metastatic Q> constexpr int constraint(Q) { return 2; }
+template <metaconst Q>  constexpr int constraint(Q) { return 3; }
+
+static_assert( constraint(test_metavalue<int>::TVCI{}) == 1 );
+static_assert( constraint(std::integral_constant<int&, global>{}) == 2 );
+static_assert( constraint(std::true_type{}) == 3 );
+
+template <metapara Q>  constexpr int parameter(Q) { return 1; }
+template <metavalue Q> constexpr int parameter(Q) { return 2; }
+template <metatype Q>  constexpr int parameter(Q) { return 3; }
+
+static_assert( parameter(std::true_type{}) == 2 );
+static_assert( parameter(voidt{}) == 3 );
+#endif
+
 
 #include "parameta.hpp"
 
@@ -321,6 +350,28 @@ static_assert( d0123.metaget<0>() == 1 && d0123.metaget<-3>() == 1 );
 static_assert( d0123.metaget<1>() == 2 && d0123.metaget<-2>() == 2 );
 static_assert( d0123.metaget<2>() == 3 && d0123.metaget<-1>() == 3 );
 
+// metaget preserves by-reference metadata, and indexes flat, not deep
+static_assert( SAME<decltype(staticmeta<0,(global),2>::metaget<0>())
+                             , staticmeta<(global)>> );
+static_assert( SAME<decltype(typemeta<int,1,(global)>::metaget<-1>())
+                             , staticmeta<(global)>> );
+
+using m40 = staticmeta<0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15,16,
+                      17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,
+                      33,34,35,36,37,38,39,40>;
+
+static_assert( m40::metasize() == 40 && m40::metaget<39>() == 40 );
+static_assert( SAME<decltype(m40::metaget<39,0,-20>()),staticmeta<40,1,21>>);
+
+// meta(f) passes the metadata pack to f.template operator()<x...>()
+struct metasum {
+  template <decltype(auto)...x> constexpr int operator()() const
+                                              { return (0 + ... + x); }
+};
+static_assert( m40::meta(metasum{}) == 820 );
+static_assert( d0123.meta(metasum{}) == 6 );
+static_assert( typemeta<int,4,5>::meta(metasum{}) == 9 );
+
 int main() {}
 
 #if __cpp_concepts
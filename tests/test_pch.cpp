@@ -0,0 +1,34 @@
+// PCH use, from configurations selected by meson: the library headers
+// precompiled, as the first include, then user code with its own macros
+#include "pch/parameta_pch.hpp"
+
+// A user typeof, as C23, unaffected by the library's local typeof
+#define typeof(...) decltype(__VA_ARGS__)
+#define SAME std::is_same_v
+
+int g;
+
+using C = NAMESPACE_ID::staticmeta<2,'c'>;
+using S = decltype(NAMESPACE_ID::makestatic<g>());
+
+static_assert( SAME<typeof(C::value), int const> );
+static_assert( NAMESPACE_ID::is_metaconst_v<C>
+            && NAMESPACE_ID::is_metastatic_v<S> );
+
+// Re-including is a no-op, so the namespace toggle is not flipped
+#include "parameta.hpp"
+#include "tunable.hpp"
+
+NAMESPACE_ID::tunable<int> t{C::value};
+
+#if __cpp_concepts
+static_assert( sizeof(NAMESPACE_ID::number<NAMESPACE_ID::staticmeta<8>,
+                      NAMESPACE_ID::staticmeta<128>,
+                      NAMESPACE_ID::staticmeta<-4>>) == 1 );
+#endif
+
+int main()
+{
+  g = t;
+  return S{}() == C{}() ? 0 : 1;
+}
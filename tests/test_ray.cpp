@@ -0,0 +1,102 @@
+#if __cpp_concepts
+#include "ray.hpp"
+
+#include <algorithm>
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+using std::unique_ptr;
+using std::make_unique;
+
+// The readme example layouts, and sizes
+
+template <typename T, int N> using array = ray<T[N], staticmeta<N>>;
+
+  array<int,2>  i2 {{4,2}}; // ray<int[2],metastatic<2>>
+  array<char,4> c4 {"str"}; // ray<char[4],metastatic<4>>
+
+template <typename P> using span = ray<P,dynameta<int>>;
+
+  char buffer[4];
+  span<char*> ps{buffer,{4}};
+
+  span<unique_ptr<char[]>> up{make_unique<char[]>(4),{4}};
+
+  ray<char(&)[4], staticmeta<4>> sp{buffer};
+
+  ray<staticmeta<buffer>, staticmeta<4>> sb{};
+
+  int extent = 4;
+  ray<char*, staticmeta<(extent)>> pg{buffer};
+
+static_assert( sizeof ps == 16 ); // pointer 8 + size 4 (4 byte pad)
+static_assert( sizeof up == 16 ); // unique_ptr 8 + int (4 byte pad)
+static_assert( sizeof sp == 8 );  // pointer 8 + static size 0
+static_assert( sizeof c4 == 4 );  // array char[4] + static size 0
+static_assert( sizeof sb == 1 );  // static ref 0 + static size 0
+static_assert( sizeof pg == 8 );  // pointer 8 + static global size 0
+
+// Element types
+static_assert( SAME<decltype(c4)::value_type, char>
+            && SAME<decltype(c4)::pointer, char*>
+            && SAME<decltype(std::as_const(c4).data()), char const*>
+            && SAME<decltype(std::as_const(ps).data()), char*>
+            && SAME<decltype(up)::element_type, char>
+            && SAME<decltype(sb)::iterator, char*> );
+
+// Static size() and data() fold to constants
+static_assert( decltype(c4)::size() == 4 && decltype(sb)::size() == 4 );
+static_assert( decltype(sb)::data() == buffer );
+
+constexpr array<int,3> i3{{1,2,3}};
+static_assert( i3.size() == 3 && i3[2] == 3 && !i3.empty()
+            && *i3.begin() == 1 && i3.end() - i3.begin() == 3 );
+
+// Alignment metadata pads and aligns in-class arrays only
+using v8 = ray<float[8], staticmeta<8, align<32>>>;
+using c3 = ray<char[3], staticmeta<3, 'x', align<64>>>;
+using pa = ray<float*, dynameta<int, align<32>>>;
+
+static_assert( v8::alignment == 32 && alignof(v8) == 32
+            && sizeof(v8) == 32 );
+static_assert( c3::alignment == 64 && alignof(c3) == 64
+            && sizeof(c3) == 64 );
+static_assert( pa::alignment == 32 && alignof(pa) == alignof(float*)
+            && sizeof(pa) == 16 );
+static_assert( decltype(c4)::alignment == 1
+            && alignof(decltype(c4)) == 1 );
+
+constexpr v8 zeros{};
+static_assert( zeros.size() == 8 && zeros[7] == 0.f );
+
+
+int main()
+{
+  std::copy_n("1234", ps.size(), ps.begin());
+  std::copy_n("1234", up.size(), up.begin());
+  std::copy_n("1234", sp.size(), sp.begin());
+  std::copy_n("1234", c4.size(), c4.begin());
+  std::copy_n("1234", sb.size(), sb.begin());
+
+  int sum = 0;
+  for (char c : c4) sum += c;
+  if (sum != '1' + '2' + '3' + '4') return 1;
+
+  if (up[3] != '4' || sb[0] != '1' || buffer[3] != '4') return 1;
+
+  extent = 2;
+  if (pg.size() != 2 || pg.end() != buffer + 2) return 1;
+
+  alignas(32) float f[16]{};
+  pa aligned{f, {16}};
+  for (float& x : aligned) x = 1;
+  if (f[15] != 1) return 1;
+
+  v8 v{};
+  if (reinterpret_cast<std::uintptr_t>(v.data()) % 32 != 0) return 1;
+}
+
+#else
+int main() {}
+#endif
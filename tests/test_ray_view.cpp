@@ -0,0 +1,94 @@
+#if __cpp_concepts
+#include "ray_view.hpp"
+
+#include <algorithm>
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+template <int v> using C = staticmeta<v>;
+
+constexpr ray<int[8], C<8>> a{{0,1,2,3,4,5,6,7}};
+
+// The identity view is contiguous, of the ray's pointer and extent
+constexpr auto all = view(a);
+static_assert( all.contiguous && all.size() == 8 && all.data() == a.data()
+            && sizeof all == sizeof(int const*) );
+
+// Constant layouts compose to constant offsets and strides
+constexpr auto odds = strided(a, C<1>{}, C<2>{}, C<4>{});
+constexpr auto rodds = reversed(odds);
+static_assert( SAME<decltype(rodds.offset), staticmeta<7L>>
+            && SAME<decltype(rodds.stride), staticmeta<-2L>> );
+static_assert( ! rodds.contiguous && decltype(rodds)::size() == 4 );
+static_assert( rodds[0] == 7 && rodds[3] == 1 );
+static_assert( sizeof rodds == sizeof(int const*) );
+
+// A constant stride 1 view is still contiguous
+constexpr auto mid = strided(a, C<2>{}, C<1>{}, C<4>{});
+static_assert( mid.contiguous && mid.data() == a.data() + 2 );
+
+// Dynamic parts are stored, only
+constexpr auto dyn = strided(a, 1, C<3>{}, C<2>{});
+static_assert( SAME<decltype(dyn.offset), dynameta<std::ptrdiff_t>>
+            && SAME<decltype(dyn.stride), staticmeta<3L>> );
+static_assert( dyn[1] == 4 );
+static_assert( sizeof dyn == sizeof(int const*) + sizeof(std::ptrdiff_t) );
+
+// Gather, and views of gathers, compose into the index view
+constexpr ray<int[3], C<3>> pick{{2,0,3}};
+constexpr auto g = gather(odds, pick);      // 5, 1, 7
+static_assert( g.size() == 3 && g[0] == 5 && g[1] == 1 && g[2] == 7 );
+constexpr auto rg = reversed(g);            // 7, 1, 5
+static_assert( rg[0] == 7 && rg[2] == 5 );
+static_assert( SAME<decltype(rg.offset), decltype(odds.offset)> );
+constexpr ray<int[2], C<2>> pick2{{2,0}};
+constexpr auto gg = gather(g, pick2);       // 7, 5
+static_assert( gg.size() == 2 && gg[0] == 7 && gg[1] == 5 );
+
+// A view of a static buffer takes no storage for its base either
+int buf[6]{10,11,12,13,14,15};
+using sbuf = ray<staticmeta<buf>, staticmeta<6>>;
+constexpr sbuf sb{};
+constexpr auto sv = reversed(strided(sb, C<0>{}, C<2>{}, C<3>{}));
+static_assert( std::is_empty_v<decltype(sv)> );
+
+// No views of temporary in-class arrays
+template <typename R>
+concept viewable = requires (R&& r) { view(static_cast<R&&>(r)); };
+static_assert( viewable<ray<int[8], C<8>>&>
+            && ! viewable<ray<int[8], C<8>>>
+            && viewable<ray<int*, C<8>>> );
+
+int main()
+{
+  int fails = 0;
+
+  fails += sv[0] != 14 || sv[2] != 10;
+
+  int data[8]{};
+  ray<int*, dynameta<int>> r{data, {8}};
+  auto evens = strided(r, 0, 2, r.size() / 2);
+  int k = 0;
+  for (int& e : evens)
+    e = ++k;
+  fails += data[0] != 1 || data[2] != 2 || data[6] != 4 || data[1] != 0;
+
+  auto back = reversed(r);
+  fails += back[0] != 0 || back[1] != 4 || back[7] != 1;
+  fails += std::count(back.begin(), back.end(), 0) != 4;
+
+  // Writes through a gather of a dynamic view reach the ray
+  int idx[2]{3, 1};
+  ray<int*, staticmeta<2>> ix{idx};
+  auto gb = gather(back, ix);
+  gb[0] = 9;
+  fails += data[4] != 9;
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
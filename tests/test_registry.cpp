@@ -0,0 +1,109 @@
+#if __cpp_concepts
+
+#include "registry.hpp"
+
+#include <cstring>
+
+using namespace NAMESPACE_ID;
+
+int batch = 64;
+double scale = 0.5;
+bool verbose = false;
+enum class mode : unsigned char { fast, exact };
+mode run_mode = mode::fast;
+
+struct range { int lo, hi; };
+range window{0, 10};
+
+// A custom parser, for a value type with no default parser
+bool parse_range(std::string_view s, range& r) noexcept
+{
+  auto const dash = s.find('-');
+  range t{};
+  return dash != s.npos
+      && parse_param(s.substr(0, dash), t.lo)
+      && parse_param(s.substr(dash + 1), t.hi)
+      && (r = t, true);
+}
+
+using batch_t = staticmeta<(batch), param_key{"batch"}>;
+using scale_t = staticmeta<(scale), param_key{"scale"}>;
+using verbose_t = staticmeta<(verbose), param_key{"verbose"}>;
+using run_mode_t = staticmeta<(run_mode), param_key{"mode"}>;
+using window_t = staticmeta<(window), param_key{"window"}, parse_range>;
+
+// The parameters are metastatic ids, unchanged by the metadata
+static_assert( is_metastatic_v<batch_t> && std::is_empty_v<window_t> );
+static_assert( impl::param_traits<window_t>::key() == "window" );
+static_assert( impl::param_traits<window_t>::parser() == parse_range );
+static_assert( impl::param_traits<batch_t>::parser()
+               == parse_param<int> );
+
+// Only non-const statics, with a key, can register
+template <typename P>
+concept registrable = requires { typename registered<P>; };
+
+int const fixed = 1;
+static_assert( registrable<batch_t> );
+static_assert( ! registrable<staticmeta<(batch)>> );
+static_assert( ! registrable<staticmeta<(fixed), param_key{"fixed"}>> );
+static_assert( ! registrable<staticmeta<8, param_key{"eight"}>> );
+
+// The registry head is constant initialized, before any registration
+registered<batch_t> batch_param;
+registered<scale_t> scale_param;
+registered<verbose_t> verbose_param;
+registered<run_mode_t> mode_param;
+registered<window_t> window_param;
+
+static_assert( sizeof batch_param == sizeof(param_node) );
+
+int main()
+{
+  int fails = 0;
+
+  std::size_t count = 0;
+  for (param_node const* n = parameters(); n; n = n->next)
+    ++count;
+  fails += count != 5;
+
+  auto const loaded = load_parameters(
+    "# tuning\n"
+    "batch = 128\n"
+    "  scale=0.25\r\n"
+    "\n"
+    "verbose = true\n"
+    "mode = 1\n"
+    "window = 4-12\n");
+  fails += ! loaded || loaded.loaded != 5;
+  fails += batch != 128 || scale != 0.25 || ! verbose;
+  fails += run_mode != mode::exact;
+  fails += window.lo != 4 || window.hi != 12;
+  fails += batch_t{}() != 128;
+
+  // Unknown keys and invalid values are counted; the value is kept
+  auto const bad = load_parameters("batch = 12x\nnosuch = 1\nbatch\n"
+                                   "scale = 2");
+  fails += bool(bad) || bad.loaded != 1 || bad.unknown != 2;
+  fails += bad.invalid != 1 || batch != 128 || scale != 2;
+
+  // Keys are matched whole, by the index, not by prefix
+  auto const near = load_parameters("batc = 1\nbatch2 = 1\nBatch = 1\n"
+                                    "window = 1-2\n");
+  fails += near.unknown != 3 || near.loaded != 1 || batch != 128;
+  fails += window.lo != 1 || window.hi != 2;
+
+  // The index is in the static slots, the first 16 for 5 parameters,
+  // with no allocation (or in none, for a scan, if there are too few)
+  std::size_t indexed = 0, beyond = 0;
+  for (std::size_t i = 0; i != LML_PARAMETA_INDEX_SLOTS; ++i)
+    (i < 16 ? indexed : beyond) += impl::param_slots[i] != nullptr;
+  fails += indexed != (LML_PARAMETA_INDEX_SLOTS < 16 ? 0 : 5);
+  fails += beyond != 0;
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,127 @@
+#if __cpp_concepts
+
+#include "snapshot.hpp"
+
+#include <cstdio>
+#include <string>
+
+using namespace NAMESPACE_ID;
+
+int batch = 64;
+double scale = 0.5;
+struct window { int lo, hi; };
+window win{0, 10};
+
+bool parse_window(std::string_view s, window& w) noexcept
+{
+  auto const dash = s.find('-');
+  return dash != s.npos && parse_param(s.substr(0, dash), w.lo)
+                        && parse_param(s.substr(dash + 1), w.hi);
+}
+
+// A pointer parameter, and a class of a pointer, opted out, aren't
+// saved; their addresses would be stale in another process
+char const* const names[]{"fast", "safe"};
+char const* mode = names[0];
+struct handle { int* p; };
+handle hnd{&batch};
+
+template <>
+inline constexpr bool NAMESPACE_ID::param_flat<handle> = false;
+
+bool parse_mode(std::string_view s, char const*& m) noexcept
+{
+  for (char const* n : names)
+    if (s == n)
+      return m = n, true;
+  return false;
+}
+bool parse_handle(std::string_view, handle&) noexcept { return false; }
+
+static_assert( param_flat<int> && param_flat<window>
+         && ! param_flat<char const*> && ! param_flat<int* [2]>
+         && ! param_flat<int window::*> && ! param_flat<handle> );
+
+using batch_t = staticmeta<(batch), param_key{"batch"}>;
+using scale_t = staticmeta<(scale), param_key{"scale"}>;
+using win_t = staticmeta<(win), param_key{"window"}, parse_window>;
+
+registered<batch_t> batch_param;
+registered<scale_t> scale_param;
+registered<win_t> win_param;
+using run_mode_t = staticmeta<(mode), param_key{"mode"}, parse_mode>;
+using hnd_t = staticmeta<(hnd), param_key{"handle"}, parse_handle>;
+registered<run_mode_t> mode_param;
+registered<hnd_t> hnd_param;
+
+// The layout hash changes with the key or the value type
+static_assert( impl::param_layout<int>("batch")
+            != impl::param_layout<int>("batches") );
+static_assert( impl::param_layout<int>("batch")
+            != impl::param_layout<unsigned>("batch") );
+static_assert( impl::param_layout<int>("batch")
+            != impl::param_layout<float>("batch") );
+static_assert( impl::param_layout<int>("batch")
+            != impl::param_layout<long>("batch") );
+
+int main()
+{
+  int fails = 0;
+
+  // Header, then an entry of layout, size and 8-byte padded bytes each
+  std::size_t const n = snapshot_size();
+  fails += n != 32 + (16 + 8) + (16 + 8) + (16 + 8);
+
+  load_parameters("batch = 128\nscale = 0.25\nwindow = 4-12\n"
+                  "mode = safe\n");
+  fails += mode != names[1];
+
+  alignas(8) unsigned char image[256];
+  fails += save_parameters(image, 8) != 0;
+  fails += save_parameters(image, sizeof image) != n;
+
+  // Restore overwrites the statics, as they were saved
+  batch = 0; scale = 0; win = {}; mode = names[0]; hnd = {};
+  fails += restore_parameters(image, n) != snapshot_status::ok;
+  fails += batch != 128 || scale != 0.25 || win.lo != 4 || win.hi != 12;
+  fails += mode != names[0] || hnd.p != nullptr; // not saved
+
+  // Malformed, truncated, old version or stale images restore nothing
+  batch = 1;
+  fails += restore_parameters(image, n - 8) != snapshot_status::bad_image;
+  fails += restore_parameters(image, 4) != snapshot_status::bad_image;
+
+  unsigned char bad[256];
+  std::memcpy(bad, image, n);
+  bad[0] ^= 1;
+  fails += restore_parameters(bad, n) != snapshot_status::bad_image;
+
+  std::memcpy(bad, image, n);
+  bad[8] += 1;                                     // the version
+  fails += restore_parameters(bad, n) != snapshot_status::bad_version;
+
+  std::memcpy(bad, image, n);
+  bad[16] ^= 1;                                    // the fingerprint
+  fails += restore_parameters(bad, n) != snapshot_status::stale;
+
+  std::memcpy(bad, image, n);
+  bad[32] ^= 1;                                    // a layout hash
+  fails += restore_parameters(bad, n) != snapshot_status::stale;
+  fails += batch != 1;
+
+  // Through a file, by mmap where available
+  std::string const path = "test_snapshot.snap";   // in the run dir
+  batch = 256;
+  fails += ! save_parameters(path.c_str());
+  batch = 0;
+  fails += restore_parameters(path.c_str()) != snapshot_status::ok;
+  fails += batch != 256 || win.hi != 12;
+  std::remove(path.c_str());
+  fails += restore_parameters(path.c_str()) != snapshot_status::no_image;
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,103 @@
+#if __cpp_concepts
+#include "storage.hpp"
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+int width = 16;
+int rows = 4;
+
+using W = staticmeta<(width)>;
+
+// The Storage follows the staticity of the Extent
+static_assert( SAME<ray_storage_t<float, staticmeta<8>>, float[8]> );
+static_assert( SAME<ray_storage_t<float, staticmeta<1024>>,
+                    pooled<float, staticmeta<1024>>> );
+static_assert( SAME<ray_storage_t<float, staticmeta<1024>, 4096>,
+                    float[1024]> );
+static_assert( SAME<ray_storage_t<float, W>, pooled<float, W>> );
+static_assert( SAME<ray_storage_t<float, dynameta<int>>, float*> );
+
+// No allocation, or pointer, for a small constant extent
+using small = decltype(make_ray<float, staticmeta<8>>());
+static_assert( sizeof(small) == 8 * sizeof(float) );
+static_assert( sizeof(decltype(make_ray<float, W>()))
+               == sizeof(float*) );
+
+int main()
+{
+  int fails = 0;
+
+  // Pools are per element type and extent
+  fails += &impl::pool_of<float, W>
+        == &impl::pool_of<float, staticmeta<(rows)>>;
+
+  auto s = make_ray<float, staticmeta<8>>();
+  fails += s.size() != 8 || s[7] != 0.f;
+
+  // Blocks are shared through the pool, and reused
+  float* first;
+  {
+    auto a = make_ray<float, W>();
+    fails += a.size() != 16 || a[15] != 0.f;
+    a[0] = 1.f;
+    first = a.data();
+  }
+  {
+    auto b = make_ray<float, W>();
+    fails += b.data() != first || b[0] != 0.f; // reused, re-initialized
+    auto c = make_ray<float, W>();
+    fails += c.data() == b.data();
+    auto d = std::move(c);
+    fails += d.data() == nullptr || c.data() != nullptr;
+  }
+
+  // A changed block size frees the old blocks, not reused
+  width = 32;
+  {
+    auto e = make_ray<float, W>();
+    fails += e.size() != 32 || e[31] != 0.f;
+  }
+  width = 16;
+
+  // Non-trivial elements are constructed and destroyed per block
+  {
+    auto t = make_ray<std::unique_ptr<int>, staticmeta<(rows)>>();
+    t[3] = std::make_unique<int>(3);
+    fails += t.size() != 4 || *t[3] != 3;
+  }
+
+  // Arena rays are freed all at once
+  arena_buffer<256> scratch;
+  auto x = make_ray<int>(scratch, 16);
+  auto y = make_ray<double>(scratch, 8);
+  fails += x.size() != 16 || y.size() != 8 || x[15] != 0;
+  fails += scratch.used() != 16 * sizeof(int) + 8 * sizeof(double);
+  auto z = make_ray<double>(scratch, 32);
+  fails += z.data() != nullptr || z.size() != 0;
+  scratch.reset();
+  auto w = make_ray<int>(scratch, 4);
+  fails += w.data() != x.data() || scratch.used() != 4 * sizeof(int);
+
+  // Allocations are aligned by address, in a misaligned buffer and for
+  // an over-aligned type, past the in-class buffer's max_align_t
+  alignas(8) unsigned char raw[64];
+  arena skewed{raw + 1, sizeof raw - 1};
+  auto* d = skewed.allocate<double>(2);
+  fails += ! d || reinterpret_cast<std::uintptr_t>(d) % alignof(double);
+  fails += skewed.used() != 7 + 2 * sizeof(double);
+  fails += skewed.allocate<double>(6) != nullptr;
+
+  struct alignas(64) line { int v; };
+  arena_buffer<512> lines;
+  lines.allocate<char>(1);
+  auto* l = lines.allocate<line>(2);
+  fails += ! l || reinterpret_cast<std::uintptr_t>(l) % 64 || l[1].v;
+
+  return fails;
+}
+
+#else
+int main() {}
+#endif
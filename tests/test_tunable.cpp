@@ -0,0 +1,139 @@
+#include "tunable.hpp"
+
+#include <thread>
+
+#define SAME std::is_same_v
+
+using namespace NAMESPACE_ID;
+
+tunable<int> batch{64};
+tunable<unsigned, std::memory_order_acquire> spin{100};
+tunable<long, 'x', std::memory_order_seq_cst> seq;
+
+using batch_t = decltype(makestatic<batch>());
+using spin_t = decltype(makestatic<spin>());
+
+// Consumers take a tunable cell as a metastatic static id
+static_assert( SAME<batch_t::value_type, tunable<int> const&> );
+static_assert( is_metastatic_v<batch_t> && !is_metaconst_v<batch_t>
+            && is_metastatic_v<spin_t> );
+
+#if __cpp_concepts
+static_assert( metastatic<batch_t, tunable<int>> );
+#endif
+
+// tunable_id<c> is a zero-size metavalue of the loaded value type
+using batch_id = tunable_id<batch>;
+static_assert( SAME<batch_id::value_type, int>
+            && SAME<decltype(batch_id{}()), int>
+            && is_metavalue_v<batch_id> && ! is_metastatic_v<batch_id>
+            && std::is_empty_v<batch_id> );
+
+#if __cpp_concepts
+static_assert( metavalue<batch_id, int> );
+#endif
+
+// Generic code may copy the value, by value_type or auto
+template <typename M>
+typename M::value_type read_twice(M m)
+{
+  typename M::value_type v = M{}();
+  auto w = m();
+  return v + w;
+}
+
+// Memory orders, from metadata, load and store in pairs
+static_assert( batch.load_order == std::memory_order_relaxed
+            && batch.store_order == std::memory_order_relaxed
+            && spin.load_order == std::memory_order_acquire
+            && spin.store_order == std::memory_order_release
+            && seq.load_order == std::memory_order_seq_cst
+            && seq.store_order == std::memory_order_seq_cst );
+
+// Zero size in consuming objects
+#ifndef _MSC_VER
+# define NUA [[no_unique_address]]
+#else
+# define NUA [[msvc::no_unique_address]]
+#endif
+
+template <typename Batch>
+struct worker {
+  NUA Batch batch;
+  int id;
+};
+static_assert( sizeof(worker<batch_t>) == sizeof(int) );
+
+// seqlocked multi-word tuning blocks
+struct tuning {
+  long threshold;
+  double lo, hi; // invariant hi == 2 * lo, if never torn
+};
+
+seqlocked<tuning> params{{16, 0.5, 1.0}};
+
+using params_t = decltype(makestatic<params>());
+using params_id = tunable_id<params>;
+
+static_assert( SAME<params_t::value_type, seqlocked<tuning> const&>
+            && is_metastatic_v<params_t> );
+static_assert( SAME<params_id::value_type, tuning>
+            && SAME<decltype(params_id{}()), tuning> );
+static_assert( sizeof(worker<params_t>) == sizeof(int)
+            && sizeof(worker<params_id>) == sizeof(int) );
+
+// T need only be trivially copyable, not default constructible
+struct span2 {
+  int lo, hi;
+  constexpr span2(int l, int h) noexcept : lo{l}, hi{h} {}
+};
+static_assert( ! std::is_default_constructible_v<span2> );
+seqlocked<span2> window{{2, 5}};
+
+int main()
+{
+  int const b = batch_t{}();
+  if (b != 64 || spin_t::value != 100u || seq != 0) return 1;
+
+  auto const n = batch_id{}();
+  tuning const t = params_id{}();
+  if (n != 64 || read_twice(batch_id{}) != 128 || t.threshold != 16)
+    return 1;
+
+  // A control thread tunes while workers read, without data races
+  std::thread control([] {
+    for (int i = 1; i <= 1000; ++i)
+      batch = i;
+  });
+  worker<batch_t> w{{}, 1};
+  int last = 0;
+  for (int i = 0; i != 100000 && last != 1000; ++i) {
+    int const n = w.batch();
+    if (n < last) return 1; // a relaxed store sequence is seen in order
+    last = n;
+  }
+  control.join();
+  if (w.batch() != 1000) return 1;
+
+  span2 const w0 = window;
+  if (w0.lo != 2 || w0.hi != 5) return 1;
+  window.publish({3, 9});
+  if (window.load().hi != 9) return 1;
+
+  tuning const t0 = params_t{}();
+  if (t0.threshold != 16 || t0.lo != 0.5 || t0.hi != 1.0) return 1;
+
+  // Readers see consistent snapshots while the owner publishes
+  std::thread owner([] {
+    for (long i = 17; i <= 10000; ++i)
+      params.publish({i, double(i), 2.0 * i});
+  });
+  worker<params_t> r{{}, 2};
+  long seen = 0;
+  while (seen != 10000) {
+    tuning const t = r.batch();
+    if (t.hi != 2 * t.lo || t.threshold < seen) return 1;
+    seen = t.threshold;
+  }
+  owner.join();
+}
@@ -0,0 +1,243 @@
+/*
+ SPDX-FileCopyrightText: 2024 The Lemuriad <opensource@lemuriad.com>
+ SPDX-License-Identifier: BSL-1.0
+ Repo: https://github.com/lemuriad/parameta
+*/
+
+#ifndef LML_TUNABLE_HPP
+#define LML_TUNABLE_HPP
+
+/*
+  tunable.hpp
+  ===========
+  Tunable static parameters, safe for lock-free live tuning; a static id
+  staticmeta<(g)> of a plain mutable static 'int g' is a data race when
+  tuned concurrently, so instead the static is an atomic tunable cell:
+
+  * tunable<T,x...> : a std::atomic<T> cell, with memory order metadata
+                      x... (default relaxed) for its loads and stores
+
+    Implicit conversion to T, or load(), loads with the memory order
+    given in the metadata; store(v), or assignment, stores with the
+    matching release order (relaxed, release or seq_cst).
+
+  Consumers take the cell by static id, of zero size, as a metavalue
+  parameter whose value is loaded, as T, by an atomic load:
+
+  * tunable_id<c> : the id of a tunable, or seqlocked, static cell c;
+                    value_type T, operator()() and conversion load T
+
+    tunable<int> batch{64};                  // static, relaxed loads
+    tunable<int, std::memory_order_acquire> spin{100};
+
+    using batch_t = tunable_id<batch>;       // zero size, of int
+    int n = batch_t{}();                     // relaxed load
+    auto m = batch_t{}();                    // int, loaded
+    batch = 128;                             // control thread, relaxed
+
+    As the value is a load, not a constant, the id isn't metastatic;
+    its 'value' member is declared, for the metavalue API, but not
+    defined. The metastatic id staticmeta<(batch)> is of the cell,
+    of value_type tunable<int> const&, whose value converts to T.
+
+  T must be trivially copyable and lock-free as std::atomic<T>.
+
+  * seqlocked<T,x...> : a multi-word T cell, e.g. a struct of tuning
+                        thresholds and coefficients, under a seqlock
+
+    Implicit conversion to T, or load(), returns a consistent snapshot;
+    readers never block the writer, and retry only if they overlap an
+    update. publish(v) is for the single owning writer; concurrent
+    writers must be serialized by the owner.
+
+    The words of T are held as relaxed atomics, with fences ordering
+    them against the sequence count, so there's no data race.
+
+    seqlocked<tuning> params{{16, 0.5f}};
+    using params_t = tunable_id<params>;         // zero size, of tuning
+
+    tuning t = params_t{}();                     // consistent snapshot
+    params.publish({32, 0.25f});                 // owner update
+
+  T must be trivially copyable; it needn't be default constructible.
+  constexpr construction, for constant initialization of statics,
+  requires std::bit_cast from C++20.
+*/
+
+#include "parameta.hpp"
+
+#include <atomic>
+#include <cstdint> // uint8_t ... uint64_t, seqlocked words
+#include <cstring> // memcpy
+#include <new>     // launder
+#if __has_include(<bit>)
+# include <bit>    // bit_cast
+#endif
+#include <utility> // index_sequence
+
+#include "namespace.hpp" // open namespace LML_NAMESPACE_ID
+
+namespace impl {
+
+constexpr std::memory_order order_of(std::memory_order m,
+                                     std::memory_order) noexcept
+{ return m; }
+template <typename X>
+constexpr std::memory_order order_of(X const&,
+                                     std::memory_order o) noexcept
+{ return o; }
+
+// meta_order<x...>() : the last memory_order value in x..., or relaxed
+template <decltype(auto)...x>
+constexpr std::memory_order meta_order() noexcept
+{
+  std::memory_order o = std::memory_order_relaxed;
+  ((o = order_of(x, o)), ...);
+  return o;
+}
+
+// store_order(o) : the store order that pairs with load order o
+constexpr std::memory_order store_order(std::memory_order o) noexcept
+{
+  return o == std::memory_order_relaxed ? std::memory_order_relaxed
+       : o == std::memory_order_seq_cst ? std::memory_order_seq_cst
+                                        : std::memory_order_release;
+}
+
+// seq_word<T> : the widest lock-free word type that divides sizeof(T)
+template <typename T> using seq_word =
+  std::conditional_t<sizeof(T) % 8 == 0
+                  && std::atomic<std::uint64_t>::is_always_lock_free,
+                     std::uint64_t,
+  std::conditional_t<sizeof(T) % 4 == 0, std::uint32_t,
+  std::conditional_t<sizeof(T) % 2 == 0, std::uint16_t,
+                                         std::uint8_t>>>;
+
+} // impl
+
+template <typename T, decltype(auto)...x>
+class tunable
+{
+  static_assert( std::atomic<T>::is_always_lock_free,
+                 "tunable<T> requires lock-free std::atomic<T>");
+
+  std::atomic<T> cell;
+
+ public:
+  using value_type = T;
+
+  // load_order, store_order : from memory_order metadata x..., paired
+  static constexpr std::memory_order load_order
+                                   = impl::meta_order<x...>();
+  static constexpr std::memory_order store_order
+                                   = impl::store_order(load_order);
+
+  constexpr tunable(T v = T{}) noexcept : cell{v} {}
+
+  tunable(tunable const&) = delete;
+  tunable& operator=(tunable const&) = delete;
+
+  T load() const noexcept { return cell.load(load_order); }
+  operator T() const noexcept { return cell.load(load_order); }
+
+  void store(T v) noexcept { cell.store(v, store_order); }
+  tunable& operator=(T v) noexcept { store(v); return *this; }
+};
+
+template <typename T, decltype(auto)...x>
+class seqlocked
+{
+  static_assert( std::is_trivially_copyable_v<T>,
+                 "seqlocked<T> requires trivially copyable T");
+
+  using word = impl::seq_word<T>;
+  static constexpr std::size_t words = sizeof(T) / sizeof(word);
+
+  std::atomic<unsigned> seq{0}; // odd while an update is in progress
+  std::atomic<word> cell[words];
+
+  struct buffer { word w[words]; };
+
+  // from_buffer(b) : the T of the bytes of b; T need not be default
+  //                  constructible, only trivially copyable
+  static T from_buffer(buffer const& b) noexcept
+  {
+#if __cpp_lib_bit_cast
+    return std::bit_cast<T>(b);
+#else
+    alignas(T) unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &b, sizeof(T));
+    return *std::launder(reinterpret_cast<T*>(bytes));
+#endif
+  }
+
+#if __cpp_lib_bit_cast
+  template <std::size_t...i>
+  constexpr seqlocked(buffer b, std::index_sequence<i...>) noexcept
+    : cell{b.w[i]...} {}
+ public:
+  constexpr seqlocked(T const& v = T{}) noexcept
+    : seqlocked(std::bit_cast<buffer>(v),
+                std::make_index_sequence<words>{}) {}
+#else
+ public:
+  seqlocked(T const& v = T{}) noexcept
+  {
+    buffer b;
+    std::memcpy(&b, &v, sizeof v);
+    for (std::size_t i = 0; i != words; ++i)
+      cell[i].store(b.w[i], std::memory_order_relaxed);
+  }
+#endif
+
+  using value_type = T;
+
+  seqlocked(seqlocked const&) = delete;
+  seqlocked& operator=(seqlocked const&) = delete;
+
+  T load() const noexcept
+  {
+    buffer b;
+    for (;;) {
+      unsigned const s = seq.load(std::memory_order_acquire);
+      if (s & 1)
+        continue;
+      for (std::size_t i = 0; i != words; ++i)
+        b.w[i] = cell[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == s)
+        break;
+    }
+    return from_buffer(b);
+  }
+  operator T() const noexcept { return load(); }
+
+  void publish(T const& v) noexcept
+  {
+    buffer b;
+    std::memcpy(&b, &v, sizeof v);
+    unsigned const s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i != words; ++i)
+      cell[i].store(b.w[i], std::memory_order_relaxed);
+    seq.store(s + 2, std::memory_order_release);
+  }
+};
+
+// tunable_id<c> : id of a static tunable or seqlocked cell c, of zero
+//                 size, whose value is loaded from c, as value_type
+template <auto& c>
+struct tunable_id
+{
+  using value_type = decltype(c.load());
+
+  static value_type const value; // declared only; it is c.load()
+
+  value_type operator()() const noexcept { return c.load(); }
+  operator value_type() const noexcept { return c.load(); }
+};
+
+#include "namespace.hpp" // close configurable namespace
+
+#endif